@@ -0,0 +1,93 @@
+#include "bc/expected.h"
+
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+constexpr std::size_t size = 4096;
+
+struct Obj {
+  int x;
+  int y;
+};
+
+void set_label(benchmark::State& state) {
+  switch (BC_STD_EXPECTED_ACCESS_CHECK) {
+  case BC_STD_EXPECTED_ACCESS_UNCHECKED:
+    state.SetLabel("unchecked");
+    break;
+  case BC_STD_EXPECTED_ACCESS_ASSERT:
+    state.SetLabel("assert");
+    break;
+  case BC_STD_EXPECTED_ACCESS_TRAP:
+    state.SetLabel("trap");
+    break;
+  default:
+    break;
+  }
+}
+
+// Sum of *e over a vector where every element holds a value.
+void indirection_operator(benchmark::State& state) {
+  const std::vector<expected<int, int>> v(size, 1);
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& e : v)
+      sum += *e;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+  set_label(state);
+}
+
+// Same as above, but the caller checks has_value() first, which makes the
+// access check redundant.
+void indirection_operator_after_check(benchmark::State& state) {
+  const std::vector<expected<int, int>> v(size, 1);
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& e : v) {
+      if (e.has_value())
+        sum += *e;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+  set_label(state);
+}
+
+void member_access_operator(benchmark::State& state) {
+  const std::vector<expected<Obj, int>> v(size, Obj{1, 2});
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& e : v)
+      sum += e->x + e->y;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+  set_label(state);
+}
+
+void error(benchmark::State& state) {
+  const std::vector<expected<int, int>> v(size, unexpected(1));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& e : v)
+      sum += e.error();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+  set_label(state);
+}
+
+} // namespace
+
+BENCHMARK(indirection_operator);
+BENCHMARK(indirection_operator_after_check);
+BENCHMARK(member_access_operator);
+BENCHMARK(error);
@@ -0,0 +1,90 @@
+#ifndef BENCH_BENCH_TYPES_H
+#define BENCH_BENCH_TYPES_H
+
+#include "bc/expected.h"
+
+#include <expected>
+#include <string>
+#include <vector>
+
+// The expected implementations under comparison.
+struct Bc {
+  static constexpr const char* name = "bc";
+
+  template <class T, class E>
+  using expected = bc::expected<T, E>;
+
+  static constexpr const bc::unexpect_t& unexpect = bc::unexpect;
+};
+
+struct Std {
+  static constexpr const char* name = "std";
+
+  template <class T, class E>
+  using expected = std::expected<T, E>;
+
+  static constexpr const std::unexpect_t& unexpect = std::unexpect;
+};
+
+// Copy and move are not noexcept, which selects the rollback paths of
+// assignment and swap.
+struct Throwing {
+  explicit Throwing(int x) : v(1, x) {}
+
+  Throwing(const Throwing& other) : v(other.v) {}
+
+  // NOLINTNEXTLINE(*-noexcept-move-operations): Not noexcept by design
+  Throwing(Throwing&& other) : v(std::move(other.v)) {}
+
+  Throwing& operator=(const Throwing&) = default;
+
+  // NOLINTNEXTLINE(*-noexcept-move-operations): Not noexcept by design
+  Throwing& operator=(Throwing&& other) {
+    v = std::move(other.v);
+    return *this;
+  }
+
+  ~Throwing() = default;
+
+  friend bool operator==(const Throwing& x, const Throwing& y) {
+    return x.v == y.v;
+  }
+
+  std::vector<int> v;
+};
+
+// The value and error types of each benchmarked case, and how to make them.
+struct Trivial {
+  static constexpr const char* name = "trivial";
+
+  using T = int;
+  using E = int;
+
+  static T value(int x) { return x; }
+  static E error(int x) { return x; }
+};
+
+struct Non_trivial {
+  static constexpr const char* name = "non_trivial";
+
+  using T = std::string;
+  using E = std::string;
+
+  // Long enough to not fit in the small string buffer.
+  static T value(int x) { return std::string(32, 'v') + std::to_string(x); }
+  static E error(int x) { return std::string(32, 'e') + std::to_string(x); }
+};
+
+// Only T throws, since assignment requires one of the alternatives to be
+// nothrow move constructible.
+struct Throwing_value {
+  static constexpr const char* name = "throwing";
+
+  using T = Throwing;
+  using E = int;
+
+  static T value(int x) { return Throwing(x); }
+  static E error(int x) { return x; }
+};
+
+#endif
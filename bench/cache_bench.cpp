@@ -0,0 +1,49 @@
+#include "bc/expected_cache.h"
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Lookup_error { not_found = 1 };
+
+constexpr std::int64_t keys = 1024;
+
+using cache_type = expected_cache<std::int64_t, std::int64_t, Lookup_error>;
+
+cache_type& filled_cache(std::size_t shards) {
+  static cache_type one({.shards = 1});
+  static cache_type many({.shards = 16});
+  cache_type& c = shards == 1 ? one : many;
+  for (std::int64_t k = 0; k < keys; ++k) {
+    if (k % 8 == 0)
+      c.insert(k, unexpected(Lookup_error::not_found));
+    else
+      c.insert(k, k);
+  }
+  return c;
+}
+
+// Lookups that all hit, an eighth of them on cached errors, from each thread.
+// With one shard, every thread takes the same shared mutex.
+void hits(benchmark::State& state) {
+  const auto shards = static_cast<std::size_t>(state.range(0));
+  static cache_type* c = nullptr;
+  if (state.thread_index() == 0)
+    c = &filled_cache(shards);
+  std::int64_t k = state.thread_index() * 97;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(c->get_or_compute(
+        k, [] { return expected<std::int64_t, Lookup_error>(0); }));
+    k = (k + 1) % keys;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+// The argument is the number of shards.
+BENCHMARK(hits)->Name("cache/hits")->Arg(1)->Arg(16)->ThreadRange(1, 8);
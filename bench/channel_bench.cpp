@@ -0,0 +1,61 @@
+#include "bc/expected_channel.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Io_error { eof = 1 };
+
+// Each iteration moves items values from Producers threads to Consumers
+// threads through a channel of 1024 slots, ending with the error.
+template <int Producers, int Consumers, bool Padded>
+void throughput(benchmark::State& state) {
+  constexpr std::int64_t items = 1 << 18;
+  constexpr std::int64_t per_producer = items / Producers;
+  for (auto _ : state) {
+    expected_channel<std::int64_t, Io_error, Padded> c(1024);
+    std::vector<std::thread> threads;
+    std::atomic<int> producing{Producers};
+    for (int p = 0; p < Producers; ++p) {
+      threads.emplace_back([&] {
+        for (std::int64_t i = 0; i < per_producer; ++i)
+          c.send(i);
+        if (producing.fetch_sub(1) == 1)
+          c.close(Io_error::eof);
+      });
+    }
+    for (int k = 0; k < Consumers; ++k) {
+      threads.emplace_back([&] {
+        std::int64_t sum = 0;
+        for (auto v = c.receive(); v.has_value(); v = c.receive())
+          sum += *v;
+        benchmark::DoNotOptimize(sum);
+      });
+    }
+    for (auto& t : threads)
+      t.join();
+  }
+  state.SetItemsProcessed(state.iterations() * items);
+}
+
+} // namespace
+
+BENCHMARK(throughput<1, 1, true>)
+    ->Name("channel/1p1c/padded")
+    ->UseRealTime();
+BENCHMARK(throughput<1, 1, false>)
+    ->Name("channel/1p1c/unpadded")
+    ->UseRealTime();
+BENCHMARK(throughput<4, 4, true>)
+    ->Name("channel/4p4c/padded")
+    ->UseRealTime();
+BENCHMARK(throughput<4, 4, false>)
+    ->Name("channel/4p4c/unpadded")
+    ->UseRealTime();
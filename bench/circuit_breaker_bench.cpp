@@ -0,0 +1,74 @@
+#include "bc/circuit_breaker.h"
+
+#include <cstdint>
+#include <mutex>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Db_error { unavailable = 1 };
+
+[[gnu::noinline]] expected<int, Db_error> query(int x) {
+  benchmark::ClobberMemory();
+  return x + 1;
+}
+
+// The usual closed state of a breaker guarded by a mutex: both counts are
+// updated under the lock.
+class mutex_breaker {
+public:
+  template <class F>
+  auto call(F&& f) {
+    auto r = f();
+    std::lock_guard lock(mutex_);
+    if (r.has_value())
+      ++successes_;
+    else
+      ++failures_;
+    return r;
+  }
+
+private:
+  std::mutex mutex_;
+  std::int64_t successes_ = 0;
+  std::int64_t failures_ = 0;
+};
+
+// Calls that all succeed, from each thread, through one shared breaker.
+void direct(benchmark::State& state) {
+  int x = 0;
+  for (auto _ : state) {
+    auto r = query(x++);
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void breaker(benchmark::State& state) {
+  static circuit_breaker<Db_error> b(Db_error::unavailable);
+  int x = 0;
+  for (auto _ : state) {
+    auto r = b.call([&] { return query(x++); });
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void mutex(benchmark::State& state) {
+  static mutex_breaker b;
+  int x = 0;
+  for (auto _ : state) {
+    auto r = b.call([&] { return query(x++); });
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(direct)->Name("circuit_breaker/direct")->ThreadRange(1, 8);
+BENCHMARK(breaker)->Name("circuit_breaker/closed")->ThreadRange(1, 8);
+BENCHMARK(mutex)->Name("circuit_breaker/mutex")->ThreadRange(1, 8);
@@ -0,0 +1,104 @@
+# Compiles each translation unit of the compile time benchmark and reports
+# its frontend time, template instantiation time, total time and object size.
+# Translation units are compiled one at a time so the timings don't compete.
+#
+# Usage:
+#   cmake -DCOMPILER=<c++> -DCOMPILER_ID=<GNU|Clang> -DFLAGS=<flags>
+#         -DSOURCES=<sources> -DOUTPUT_DIR=<dir> -P report.cmake
+#
+# FLAGS and SOURCES are lists. The summary is also written to
+# OUTPUT_DIR/compile_time.txt.
+
+cmake_minimum_required(VERSION 3.23)
+
+foreach(var IN ITEMS COMPILER COMPILER_ID SOURCES OUTPUT_DIR)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "${var} is not set")
+  endif()
+endforeach()
+
+# Converts a number of seconds such as 1.22 to milliseconds.
+function(seconds_to_ms seconds out)
+  if(NOT seconds MATCHES "^([0-9]+)\\.?([0-9]*)$")
+    message(FATAL_ERROR "Not a number of seconds: ${seconds}")
+  endif()
+  set(whole ${CMAKE_MATCH_1})
+  string(SUBSTRING "${CMAKE_MATCH_2}000" 0 3 frac)
+  math(EXPR ms "${whole} * 1000 + ${frac}")
+  set(${out} ${ms} PARENT_SCOPE)
+endfunction()
+
+# Wall time of a -ftime-report line, in milliseconds. 0 if absent.
+function(gcc_time report name out)
+  set(ms 0)
+  string(REGEX MATCH " ${name} +:[^\n]*" line "${report}")
+  if(line)
+    # usr ( %) sys ( %) wall ( %)
+    string(REGEX MATCHALL "[0-9]+\\.[0-9]+" times "${line}")
+    list(GET times 2 wall)
+    seconds_to_ms(${wall} ms)
+  endif()
+  set(${out} ${ms} PARENT_SCOPE)
+endfunction()
+
+# Duration of a -ftime-trace summary event, in milliseconds. 0 if absent.
+function(clang_time trace name out)
+  set(ms 0)
+  string(REGEX MATCH "{[^{}]*\"name\":\"${name}\"[^{}]*" event "${trace}")
+  if(event MATCHES "\"dur\":([0-9]+)")
+    math(EXPR ms "${CMAKE_MATCH_1} / 1000")
+  endif()
+  set(${out} ${ms} PARENT_SCOPE)
+endfunction()
+
+set(columns "tu" "frontend_ms" "instantiation_ms" "total_ms" "object_bytes")
+list(JOIN columns "\t" summary)
+foreach(column IN ITEMS frontend instantiation total size)
+  set(sum_${column} 0)
+endforeach()
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+foreach(source IN LISTS SOURCES)
+  get_filename_component(name ${source} NAME_WE)
+  set(object ${OUTPUT_DIR}/${name}.o)
+  if(COMPILER_ID MATCHES "Clang")
+    set(time_flag -ftime-trace)
+  else()
+    set(time_flag -ftime-report)
+  endif()
+  execute_process(
+    COMMAND ${COMPILER} ${FLAGS} ${time_flag} -c ${source} -o ${object}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE report
+  )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Compiling ${source} failed:\n${report}")
+  endif()
+
+  if(COMPILER_ID MATCHES "Clang")
+    file(READ ${OUTPUT_DIR}/${name}.json trace)
+    clang_time("${trace}" "Total Frontend" frontend)
+    clang_time("${trace}" "Total InstantiateClass" class)
+    clang_time("${trace}" "Total InstantiateFunction" function)
+    clang_time("${trace}" "Total ExecuteCompiler" total)
+    math(EXPR instantiation "${class} + ${function}")
+  else()
+    gcc_time("${report}" "phase parsing" parsing)
+    gcc_time("${report}" "phase lang. deferred" deferred)
+    gcc_time("${report}" "template instantiation" instantiation)
+    gcc_time("${report}" "TOTAL" total)
+    math(EXPR frontend "${parsing} + ${deferred}")
+  endif()
+  file(SIZE ${object} size)
+
+  string(APPEND summary
+    "\n${name}\t${frontend}\t${instantiation}\t${total}\t${size}")
+  foreach(column IN ITEMS frontend instantiation total size)
+    math(EXPR sum_${column} "${sum_${column}} + ${${column}}")
+  endforeach()
+endforeach()
+
+string(APPEND summary
+  "\nall\t${sum_frontend}\t${sum_instantiation}\t${sum_total}\t${sum_size}")
+file(WRITE ${OUTPUT_DIR}/compile_time.txt "${summary}\n")
+message("${summary}")
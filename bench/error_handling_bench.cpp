@@ -0,0 +1,115 @@
+#include "bench_types.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// The same fallible operation reported through each error handling strategy.
+// The functions are not inlined so that the result crosses a call boundary,
+// as it would in real code.
+constexpr int division_by_zero = 1;
+
+[[gnu::noinline]] int divide_code(int x, int y, int& result) {
+  if (y == 0)
+    return division_by_zero;
+  result = x / y;
+  return 0;
+}
+
+[[gnu::noinline]] int divide_throw(int x, int y) {
+  if (y == 0)
+    throw std::domain_error("division by zero");
+  return x / y;
+}
+
+[[gnu::noinline]] bc::expected<int, int> divide_bc(int x, int y) {
+  if (y == 0)
+    return bc::unexpected(division_by_zero);
+  return x / y;
+}
+
+[[gnu::noinline]] std::expected<int, int> divide_std(int x, int y) {
+  if (y == 0)
+    return std::unexpected(division_by_zero);
+  return x / y;
+}
+
+// The argument is the percentage of divisions that fail.
+std::vector<int> make_divisors(const benchmark::State& state) {
+  constexpr std::size_t size = 4096;
+  const auto error_percent = static_cast<std::size_t>(state.range(0));
+  std::vector<int> v(size);
+  for (std::size_t i = 0; i != size; ++i)
+    v[i] = (i * 37) % 100 < error_percent ? 0 : static_cast<int>(i % 7) + 1;
+  return v;
+}
+
+void set_items(benchmark::State& state, std::size_t per_iteration) {
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * per_iteration));
+}
+
+void error_code(benchmark::State& state) {
+  const auto divisors = make_divisors(state);
+  for (auto _ : state) {
+    int sum = 0;
+    int errors = 0;
+    for (int y : divisors) {
+      int result = 0;
+      if (divide_code(1000, y, result) == 0)
+        sum += result;
+      else
+        ++errors;
+    }
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(errors);
+  }
+  set_items(state, divisors.size());
+}
+
+void exception(benchmark::State& state) {
+  const auto divisors = make_divisors(state);
+  for (auto _ : state) {
+    int sum = 0;
+    int errors = 0;
+    for (int y : divisors) {
+      try {
+        sum += divide_throw(1000, y);
+      } catch (const std::domain_error&) {
+        ++errors;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(errors);
+  }
+  set_items(state, divisors.size());
+}
+
+template <class Impl, auto Divide>
+void expected(benchmark::State& state) {
+  const auto divisors = make_divisors(state);
+  for (auto _ : state) {
+    int sum = 0;
+    int errors = 0;
+    for (int y : divisors) {
+      if (auto result = Divide(1000, y))
+        sum += *result;
+      else
+        ++errors;
+    }
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(errors);
+  }
+  set_items(state, divisors.size());
+}
+
+} // namespace
+
+BENCHMARK(error_code)->Name("divide/error_code")->Arg(0)->Arg(10);
+BENCHMARK(exception)->Name("divide/exception")->Arg(0)->Arg(10);
+BENCHMARK(expected<Bc, divide_bc>)->Name("divide/bc")->Arg(0)->Arg(10);
+BENCHMARK(expected<Std, divide_std>)->Name("divide/std")->Arg(0)->Arg(10);
@@ -0,0 +1,192 @@
+#include "bench_types.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+template <class Impl, class Types>
+using Exp = typename Impl::template expected<typename Types::T,
+                                             typename Types::E>;
+
+template <class Impl, class Types>
+Exp<Impl, Types> make(bool has_value, int x) {
+  if (has_value)
+    return Exp<Impl, Types>(std::in_place, Types::value(x));
+  return Exp<Impl, Types>(Impl::unexpect, Types::error(x));
+}
+
+// Operations that change the state of their target are measured over a batch
+// of objects prepared with the timer paused, so that each transition is
+// measured on its own.
+constexpr std::size_t batch_size = 1024;
+
+template <class Impl, class Types>
+std::vector<Exp<Impl, Types>> make_batch(bool has_value) {
+  std::vector<Exp<Impl, Types>> v;
+  v.reserve(batch_size);
+  for (std::size_t i = 0; i != batch_size; ++i)
+    v.push_back(make<Impl, Types>(has_value, static_cast<int>(i)));
+  return v;
+}
+
+void set_items(benchmark::State& state, std::size_t per_iteration) {
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * per_iteration));
+}
+
+template <class Impl, class Types, bool Has_value>
+void construct(benchmark::State& state) {
+  const typename Types::T v = Types::value(1);
+  const typename Types::E e = Types::error(1);
+  for (auto _ : state) {
+    if constexpr (Has_value) {
+      Exp<Impl, Types> x(std::in_place, v);
+      benchmark::DoNotOptimize(x);
+    } else {
+      Exp<Impl, Types> x(Impl::unexpect, e);
+      benchmark::DoNotOptimize(x);
+    }
+  }
+  set_items(state, 1);
+}
+
+template <class Impl, class Types, bool Has_value, bool Move>
+void copy_move_construct(benchmark::State& state) {
+  std::vector<Exp<Impl, Types>> dst;
+  dst.reserve(batch_size);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto src = make_batch<Impl, Types>(Has_value);
+    dst.clear();
+    state.ResumeTiming();
+    for (auto& x : src) {
+      if constexpr (Move)
+        dst.emplace_back(std::move(x));
+      else
+        dst.emplace_back(x);
+    }
+    benchmark::ClobberMemory();
+  }
+  set_items(state, batch_size);
+}
+
+template <class Impl, class Types, bool From, bool To, bool Move>
+void assign(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto dst = make_batch<Impl, Types>(From);
+    auto src = make_batch<Impl, Types>(To);
+    state.ResumeTiming();
+    for (std::size_t i = 0; i != batch_size; ++i) {
+      if constexpr (Move)
+        dst[i] = std::move(src[i]);
+      else
+        dst[i] = src[i];
+    }
+    benchmark::ClobberMemory();
+  }
+  set_items(state, batch_size);
+}
+
+template <class Impl, class Types, bool From, bool To>
+void swap(benchmark::State& state) {
+  auto x = make_batch<Impl, Types>(From);
+  auto y = make_batch<Impl, Types>(To);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i != batch_size; ++i)
+      x[i].swap(y[i]);
+    benchmark::ClobberMemory();
+  }
+  set_items(state, batch_size);
+}
+
+template <class Impl, class Types, bool From>
+void emplace(benchmark::State& state) {
+  const typename Types::T v = Types::value(1);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto dst = make_batch<Impl, Types>(From);
+    state.ResumeTiming();
+    for (auto& x : dst)
+      x.emplace(v);
+    benchmark::ClobberMemory();
+  }
+  set_items(state, batch_size);
+}
+
+template <class Impl, class Types>
+void value(benchmark::State& state) {
+  const auto x = make<Impl, Types>(true, 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(x.value());
+  }
+  set_items(state, 1);
+}
+
+template <class Impl, class Types, bool X_has_value, bool Y_has_value>
+void compare(benchmark::State& state) {
+  const auto x = make<Impl, Types>(X_has_value, 1);
+  const auto y = make<Impl, Types>(Y_has_value, 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(y);
+    benchmark::DoNotOptimize(x == y);
+  }
+  set_items(state, 1);
+}
+
+template <class Impl, class Types>
+void register_benchmarks() {
+  const std::string suffix =
+      std::string("/") + Impl::name + "/" + Types::name;
+  auto add = [&](const char* name, auto fn) {
+    benchmark::RegisterBenchmark((name + suffix).c_str(), fn);
+  };
+  add("construct/value", construct<Impl, Types, true>);
+  add("construct/error", construct<Impl, Types, false>);
+  add("copy_construct/value", copy_move_construct<Impl, Types, true, false>);
+  add("copy_construct/error", copy_move_construct<Impl, Types, false, false>);
+  add("move_construct/value", copy_move_construct<Impl, Types, true, true>);
+  add("move_construct/error", copy_move_construct<Impl, Types, false, true>);
+  add("copy_assign/value_value", assign<Impl, Types, true, true, false>);
+  add("copy_assign/value_error", assign<Impl, Types, true, false, false>);
+  add("copy_assign/error_value", assign<Impl, Types, false, true, false>);
+  add("copy_assign/error_error", assign<Impl, Types, false, false, false>);
+  add("move_assign/value_value", assign<Impl, Types, true, true, true>);
+  add("move_assign/value_error", assign<Impl, Types, true, false, true>);
+  add("move_assign/error_value", assign<Impl, Types, false, true, true>);
+  add("move_assign/error_error", assign<Impl, Types, false, false, true>);
+  add("swap/value_value", swap<Impl, Types, true, true>);
+  add("swap/value_error", swap<Impl, Types, true, false>);
+  add("swap/error_error", swap<Impl, Types, false, false>);
+  // std::expected::emplace requires a nothrow constructor.
+  if constexpr (requires(Exp<Impl, Types> x, const typename Types::T& v) {
+                  x.emplace(v);
+                }) {
+    add("emplace/value", emplace<Impl, Types, true>);
+    add("emplace/error", emplace<Impl, Types, false>);
+  }
+  add("value", value<Impl, Types>);
+  add("compare/value_value", compare<Impl, Types, true, true>);
+  add("compare/value_error", compare<Impl, Types, true, false>);
+  add("compare/error_error", compare<Impl, Types, false, false>);
+}
+
+template <class... Types>
+void register_implementations() {
+  (register_benchmarks<Bc, Types>(), ...);
+  (register_benchmarks<Std, Types>(), ...);
+}
+
+const bool registered = [] {
+  register_implementations<Trivial, Non_trivial, Throwing_value>();
+  return true;
+}();
+
+} // namespace
@@ -0,0 +1,83 @@
+#include "bc/expected_future.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Task_error { failed = 1, broken };
+
+} // namespace
+
+template <>
+struct bc::broken_promise_error<Task_error> {
+  static Task_error error() { return Task_error::broken; }
+};
+
+namespace {
+
+// std::promise reports errors through exceptions; the happy path is compared.
+struct Std {
+  using promise = std::promise<int>;
+
+  static int get(std::future<int>& f) { return f.get(); }
+};
+
+struct Bc {
+  using promise = expected_promise<int, Task_error>;
+
+  static int get(expected_future<int, Task_error>& f) { return *f.get(); }
+};
+
+// Shared state, set and get on one thread: the cost of the shared state
+// itself.
+template <class Impl>
+void same_thread(benchmark::State& state) {
+  int i = 0;
+  for (auto _ : state) {
+    typename Impl::promise p;
+    auto f = p.get_future();
+    p.set_value(++i);
+    benchmark::DoNotOptimize(Impl::get(f));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// A worker thread sets each result while the caller waits for it.
+template <class Impl>
+void across_threads(benchmark::State& state) {
+  using promise = typename Impl::promise;
+  std::atomic<promise*> mailbox{nullptr};
+  std::atomic<bool> done{false};
+  std::thread worker([&] {
+    int i = 0;
+    while (!done.load(std::memory_order_relaxed)) {
+      promise* p = mailbox.exchange(nullptr, std::memory_order_acquire);
+      if (p != nullptr)
+        p->set_value(++i);
+      else
+        std::this_thread::yield();
+    }
+  });
+  for (auto _ : state) {
+    promise p;
+    auto f = p.get_future();
+    mailbox.store(&p, std::memory_order_release);
+    benchmark::DoNotOptimize(Impl::get(f));
+  }
+  done.store(true, std::memory_order_relaxed);
+  worker.join();
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(same_thread<Std>)->Name("future/same_thread/std");
+BENCHMARK(same_thread<Bc>)->Name("future/same_thread/expected");
+BENCHMARK(across_threads<Std>)->Name("future/across_threads/std");
+BENCHMARK(across_threads<Bc>)->Name("future/across_threads/expected");
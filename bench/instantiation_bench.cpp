@@ -0,0 +1,59 @@
+// Compile time benchmark: instantiates 500 distinct expected<T, E> along with
+// their special members, assignment and swap. Half of the value types are
+// trivial, half are not, so that both the trivial and the non-trivial special
+// members are instantiated. Build bench_bcexpected_instantiation to time it.
+
+#include "bc/expected.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace {
+
+template <std::size_t N>
+struct Trivial {
+  int x;
+};
+
+template <std::size_t N>
+struct Non_trivial {
+  Non_trivial(int x) : x(x) {}
+  Non_trivial(const Non_trivial& other) : x(other.x) {}
+  Non_trivial(Non_trivial&& other) noexcept : x(other.x) {}
+  Non_trivial& operator=(const Non_trivial& other) {
+    x = other.x;
+    return *this;
+  }
+  Non_trivial& operator=(Non_trivial&& other) noexcept {
+    x = other.x;
+    return *this;
+  }
+  ~Non_trivial() {}
+
+  int x;
+};
+
+template <class T, class E>
+int use(int x) {
+  bc::expected<T, E> a(std::in_place, T{x});
+  bc::expected<T, E> b(bc::unexpect, E{});
+  bc::expected<T, E> c(a);
+  bc::expected<T, E> d(std::move(b));
+  c = d;
+  d = std::move(a);
+  c.swap(d);
+  return c.has_value() ? c->x : d->x;
+}
+
+template <std::size_t... I>
+int use_all(int x, std::index_sequence<I...>) {
+  return (use<Trivial<I>, int>(x) + ...) +
+         (use<Non_trivial<I>, std::string>(x) + ...);
+}
+
+} // namespace
+
+int main(int argc, char* /*argv*/[]) {
+  return use_all(argc, std::make_index_sequence<250>()) == 0 ? 0 : 1;
+}
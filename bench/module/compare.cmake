@@ -0,0 +1,44 @@
+# Builds the bench_include and bench_import targets of this directory one at a
+# time, serially, and prints the time each takes. The module itself is built
+# first and timed on its own, since every importer depends on it.
+#
+# Usage:
+#   cmake -DBUILD_DIR=<dir> [-DBENCH_TUS=100] -P bench/module/compare.cmake
+
+cmake_minimum_required(VERSION 3.28)
+
+if(NOT DEFINED BUILD_DIR)
+  message(FATAL_ERROR "BUILD_DIR is not set")
+endif()
+if(NOT DEFINED BENCH_TUS)
+  set(BENCH_TUS 100)
+endif()
+
+function(now_us out)
+  # Seconds followed by the six digits of microseconds.
+  string(TIMESTAMP us "%s%f")
+  set(${out} ${us} PARENT_SCOPE)
+endfunction()
+
+function(run)
+  execute_process(
+    COMMAND ${ARGN}
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE output
+  )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${ARGN} failed:\n${output}")
+  endif()
+endfunction()
+
+run(${CMAKE_COMMAND} -S ${CMAKE_CURRENT_LIST_DIR} -B ${BUILD_DIR}
+  -DCMAKE_BUILD_TYPE=Release -DBENCH_TUS=${BENCH_TUS})
+
+foreach(target IN ITEMS bcexpected_module bench_include bench_import)
+  now_us(start)
+  run(${CMAKE_COMMAND} --build ${BUILD_DIR} --target ${target} --parallel 1)
+  now_us(end)
+  math(EXPR ms "(${end} - ${start}) / 1000")
+  message("${target}\t${ms} ms")
+endforeach()
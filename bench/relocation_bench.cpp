@@ -0,0 +1,95 @@
+#include "bc/expected.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+// The same type with and without the trivially relocatable opt-in.
+template <bool Relocatable>
+struct Obj {
+  explicit Obj(int x) : p(std::make_unique<int>(x)) {}
+
+  std::unique_ptr<int> p;
+};
+
+} // namespace
+
+template <>
+struct bc::is_trivially_relocatable<Obj<true>> : std::true_type {};
+
+namespace {
+
+template <bool Relocatable>
+using Expected = expected<Obj<Relocatable>, Obj<Relocatable>>;
+
+template <bool Relocatable>
+int key(const Expected<Relocatable>& e) {
+  return e.has_value() ? *e->p : -*e.error().p;
+}
+
+// Half of the elements hold an error, so that most swaps are between an
+// element holding a value and one holding an error.
+template <bool Relocatable>
+std::vector<Expected<Relocatable>> make_input() {
+  constexpr int size = 4096;
+  std::vector<Expected<Relocatable>> v;
+  v.reserve(size);
+  for (int i = 0; i != size; ++i) {
+    const int x = (i * 7919) % size;
+    if (x % 2 == 0)
+      v.emplace_back(unexpect, x);
+    else
+      v.emplace_back(std::in_place, x);
+  }
+  return v;
+}
+
+template <bool Relocatable>
+void swap_mixed(benchmark::State& state) {
+  auto v = make_input<Relocatable>();
+  for (auto _ : state) {
+    for (std::size_t i = 1; i < v.size(); i += 2)
+      v[i - 1].swap(v[i]);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * v.size() / 2));
+}
+
+template <bool Relocatable>
+void sort(benchmark::State& state) {
+  const auto input = make_input<Relocatable>();
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<Expected<Relocatable>> v;
+    v.reserve(input.size());
+    for (const auto& e : input) {
+      if (e.has_value())
+        v.emplace_back(std::in_place, *e->p);
+      else
+        v.emplace_back(unexpect, *e.error().p);
+    }
+    state.ResumeTiming();
+    std::sort(v.begin(), v.end(), [](const auto& x, const auto& y) {
+      return key<Relocatable>(x) < key<Relocatable>(y);
+    });
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+} // namespace
+
+BENCHMARK(swap_mixed<false>)->Name("swap_mixed/move");
+BENCHMARK(swap_mixed<true>)->Name("swap_mixed/relocate");
+BENCHMARK(sort<false>)->Name("sort/move");
+BENCHMARK(sort<true>)->Name("sort/relocate");
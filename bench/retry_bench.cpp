@@ -0,0 +1,42 @@
+#include "bc/retry.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Fetch_error { timeout = 1 };
+
+[[gnu::noinline]] expected<int, Fetch_error> fetch(int x) {
+  benchmark::ClobberMemory();
+  return x + 1;
+}
+
+// The overhead of retry when the first attempt succeeds: the same callable,
+// called directly and through retry.
+void direct(benchmark::State& state) {
+  int x = 0;
+  auto f = [&] { return fetch(x); };
+  for (auto _ : state) {
+    auto r = f();
+    benchmark::DoNotOptimize(r);
+    ++x;
+  }
+}
+
+void retried(benchmark::State& state) {
+  const retry_policy policy{{.max_attempts = 5}};
+  int x = 0;
+  auto f = [&] { return fetch(x); };
+  for (auto _ : state) {
+    auto r = retry(policy, f);
+    benchmark::DoNotOptimize(r);
+    ++x;
+  }
+}
+
+} // namespace
+
+BENCHMARK(direct)->Name("retry/first_success/direct");
+BENCHMARK(retried)->Name("retry/first_success/retry");
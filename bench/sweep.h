@@ -0,0 +1,92 @@
+#ifndef BENCH_SWEEP_H
+#define BENCH_SWEEP_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// A request goes through `depth` layers of calls that propagate errors, and
+// then through parse, validate and lookup, each of which can fail. Each error
+// handling strategy is implemented in its own translation unit, compiled once
+// per error size, so that the code size of each can be measured on its own.
+
+enum class Errc : std::uint8_t {
+  parse_error = 1,
+  out_of_range,
+  not_found
+};
+
+// An error of the given size in bytes. Size 1 is the bare enum.
+template <std::size_t Size>
+struct Error {
+  Errc code;
+  std::array<unsigned char, Size - 1> detail;
+};
+
+template <std::size_t Size>
+using error_type = std::conditional_t<Size == 1, Errc, Error<Size>>;
+
+template <class E>
+E make_error(Errc code) {
+  if constexpr (std::is_same_v<E, Errc>) {
+    return code;
+  } else {
+    E e{code, {}};
+    e.detail.fill(static_cast<unsigned char>(code));
+    return e;
+  }
+}
+
+constexpr int table_size = 1024;
+
+// Every 17th key is missing.
+inline int table_value(int key) {
+  return key % 17 == 0 ? -1 : key * 3;
+}
+
+// Returns the looked up value, or -1 on failure.
+template <std::size_t Error_size>
+int handle_expected(std::string_view input, int depth);
+
+template <std::size_t Error_size>
+int handle_exception(std::string_view input, int depth);
+
+int handle_error_code(std::string_view input, int depth);
+
+// Failures are spread evenly over the three stages.
+inline std::vector<std::string> make_inputs(int failure_percent,
+                                            std::size_t size) {
+  std::mt19937 gen(42); // NOLINT(*-msc51-cpp): Reproducible
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::uniform_int_distribution<int> key(0, table_size - 1);
+  std::vector<std::string> inputs;
+  inputs.reserve(size);
+  for (std::size_t i = 0; i != size; ++i) {
+    int k = key(gen);
+    if (percent(gen) >= failure_percent) {
+      if (table_value(k) < 0)
+        ++k;
+      inputs.push_back(std::to_string(k));
+      continue;
+    }
+    switch (i % 3) {
+    case 0:
+      inputs.push_back(std::to_string(k) + "x");
+      break;
+    case 1:
+      inputs.push_back(std::to_string(k + table_size));
+      break;
+    default:
+      inputs.push_back(std::to_string(k - k % 17));
+      break;
+    }
+  }
+  return inputs;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include "sweep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using Handler = int (*)(std::string_view, int);
+
+constexpr std::size_t input_size = 4096;
+
+// Arguments: failure percentage, call depth.
+std::vector<std::string> inputs_for(const benchmark::State& state) {
+  return make_inputs(static_cast<int>(state.range(0)), input_size);
+}
+
+template <Handler Handle>
+void throughput(benchmark::State& state) {
+  const auto inputs = inputs_for(state);
+  const auto depth = static_cast<int>(state.range(1));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& input : inputs)
+      sum += Handle(input, depth);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * inputs.size()));
+}
+
+// Times every call. The clock adds the same overhead to every strategy, so
+// compare the percentiles between strategies rather than as absolute values.
+template <Handler Handle>
+void latency(benchmark::State& state) {
+  using clock = std::chrono::steady_clock;
+  constexpr std::size_t max_samples = std::size_t{1} << 20;
+  const auto inputs = inputs_for(state);
+  const auto depth = static_cast<int>(state.range(1));
+  std::vector<clock::duration> samples;
+  samples.reserve(max_samples);
+  for (auto _ : state) {
+    for (const auto& input : inputs) {
+      const auto start = clock::now();
+      benchmark::DoNotOptimize(Handle(input, depth));
+      const auto stop = clock::now();
+      if (samples.size() != max_samples)
+        samples.push_back(stop - start);
+    }
+  }
+  auto percentile = [&](std::size_t p) {
+    auto nth = samples.begin() + static_cast<std::ptrdiff_t>(
+                                     (samples.size() - 1) * p / 100);
+    std::nth_element(samples.begin(), nth, samples.end());
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(*nth).count());
+  };
+  state.counters["p50_ns"] = percentile(50);
+  state.counters["p99_ns"] = percentile(99);
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * inputs.size()));
+}
+
+template <Handler Handle>
+void register_handler(const std::string& name) {
+  const std::vector<int64_t> failure_percents = {0, 1, 5, 10, 25, 50, 100};
+  const std::vector<int64_t> depths = {1, 16};
+  benchmark::RegisterBenchmark(("throughput/" + name).c_str(),
+                               throughput<Handle>)
+      ->ArgsProduct({failure_percents, depths})
+      ->ArgNames({"fail%", "depth"});
+  benchmark::RegisterBenchmark(("latency/" + name).c_str(), latency<Handle>)
+      ->ArgsProduct({failure_percents, depths})
+      ->ArgNames({"fail%", "depth"});
+}
+
+const bool registered = [] {
+  register_handler<handle_error_code>("error_code");
+  register_handler<handle_expected<1>>("expected/e1");
+  register_handler<handle_expected<16>>("expected/e16");
+  register_handler<handle_expected<64>>("expected/e64");
+  register_handler<handle_exception<1>>("exception/e1");
+  register_handler<handle_exception<16>>("exception/e16");
+  register_handler<handle_exception<64>>("exception/e64");
+  return true;
+}();
+
+} // namespace
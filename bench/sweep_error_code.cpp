@@ -0,0 +1,60 @@
+#include "sweep.h"
+
+#include <string_view>
+
+namespace {
+
+[[gnu::noinline]] Errc parse(std::string_view s, int& v) {
+  if (s.empty())
+    return Errc::parse_error;
+  v = 0;
+  for (char c : s) {
+    if (c < '0' || c > '9')
+      return Errc::parse_error;
+    v = v * 10 + (c - '0');
+  }
+  return {};
+}
+
+[[gnu::noinline]] Errc validate(int key, int& v) {
+  if (key >= table_size)
+    return Errc::out_of_range;
+  v = key;
+  return {};
+}
+
+[[gnu::noinline]] Errc lookup(int key, int& v) {
+  v = table_value(key);
+  if (v < 0)
+    return Errc::not_found;
+  return {};
+}
+
+// Layers call the next one through a volatile pointer, so that the compiler
+// keeps a frame per layer instead of turning the recursion into a loop.
+Errc layer(std::string_view s, int depth, int& v);
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables): Opaque to the optimizer
+Errc (*volatile next_layer)(std::string_view, int, int&) = layer;
+
+[[gnu::noinline]] Errc layer(std::string_view s, int depth, int& v) {
+  if (depth == 0) {
+    int key = 0;
+    if (Errc ec = parse(s, key); ec != Errc{})
+      return ec;
+    if (Errc ec = validate(key, key); ec != Errc{})
+      return ec;
+    return lookup(key, v);
+  }
+  if (Errc ec = next_layer(s, depth - 1, v); ec != Errc{})
+    return ec;
+  ++v;
+  return {};
+}
+
+} // namespace
+
+int handle_error_code(std::string_view input, int depth) {
+  int v = 0;
+  return layer(input, depth, v) == Errc{} ? v : -1;
+}
@@ -0,0 +1,62 @@
+#include "sweep.h"
+
+#include <string_view>
+
+namespace {
+
+using E = error_type<BENCH_SWEEP_ERROR_SIZE>;
+
+struct Failure {
+  E error;
+};
+
+[[gnu::noinline]] int parse(std::string_view s) {
+  if (s.empty())
+    throw Failure{make_error<E>(Errc::parse_error)};
+  int v = 0;
+  for (char c : s) {
+    if (c < '0' || c > '9')
+      throw Failure{make_error<E>(Errc::parse_error)};
+    v = v * 10 + (c - '0');
+  }
+  return v;
+}
+
+[[gnu::noinline]] int validate(int key) {
+  if (key >= table_size)
+    throw Failure{make_error<E>(Errc::out_of_range)};
+  return key;
+}
+
+[[gnu::noinline]] int lookup(int key) {
+  const int v = table_value(key);
+  if (v < 0)
+    throw Failure{make_error<E>(Errc::not_found)};
+  return v;
+}
+
+// Layers call the next one through a volatile pointer, so that the compiler
+// keeps a frame per layer instead of turning the recursion into a loop.
+int layer(std::string_view s, int depth);
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables): Opaque to the optimizer
+int (*volatile next_layer)(std::string_view, int) = layer;
+
+[[gnu::noinline]] int layer(std::string_view s, int depth) {
+  if (depth == 0)
+    return lookup(validate(parse(s)));
+  return next_layer(s, depth - 1) + 1;
+}
+
+} // namespace
+
+template <std::size_t Error_size>
+int handle_exception(std::string_view input, int depth) {
+  try {
+    return layer(input, depth);
+  } catch (const Failure&) {
+    return -1;
+  }
+}
+
+template int handle_exception<BENCH_SWEEP_ERROR_SIZE>(std::string_view, int);
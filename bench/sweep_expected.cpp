@@ -0,0 +1,67 @@
+#include "sweep.h"
+
+#include "bc/expected.h"
+
+#include <string_view>
+
+namespace {
+
+using E = error_type<BENCH_SWEEP_ERROR_SIZE>;
+
+[[gnu::noinline]] bc::expected<int, E> parse(std::string_view s) {
+  if (s.empty())
+    return bc::unexpected(make_error<E>(Errc::parse_error));
+  int v = 0;
+  for (char c : s) {
+    if (c < '0' || c > '9')
+      return bc::unexpected(make_error<E>(Errc::parse_error));
+    v = v * 10 + (c - '0');
+  }
+  return v;
+}
+
+[[gnu::noinline]] bc::expected<int, E> validate(int key) {
+  if (key >= table_size)
+    return bc::unexpected(make_error<E>(Errc::out_of_range));
+  return key;
+}
+
+[[gnu::noinline]] bc::expected<int, E> lookup(int key) {
+  const int v = table_value(key);
+  if (v < 0)
+    return bc::unexpected(make_error<E>(Errc::not_found));
+  return v;
+}
+
+// Layers call the next one through a volatile pointer, so that the compiler
+// keeps a frame per layer instead of turning the recursion into a loop.
+bc::expected<int, E> layer(std::string_view s, int depth);
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables): Opaque to the optimizer
+bc::expected<int, E> (*volatile next_layer)(std::string_view, int) = layer;
+
+[[gnu::noinline]] bc::expected<int, E> layer(std::string_view s, int depth) {
+  if (depth == 0) {
+    auto key = parse(s);
+    if (!key)
+      return bc::unexpected(std::move(key).error());
+    auto valid = validate(*key);
+    if (!valid)
+      return bc::unexpected(std::move(valid).error());
+    return lookup(*valid);
+  }
+  auto r = next_layer(s, depth - 1);
+  if (!r)
+    return bc::unexpected(std::move(r).error());
+  return *r + 1;
+}
+
+} // namespace
+
+template <std::size_t Error_size>
+int handle_expected(std::string_view input, int depth) {
+  auto r = layer(input, depth);
+  return r ? *r : -1;
+}
+
+template int handle_expected<BENCH_SWEEP_ERROR_SIZE>(std::string_view, int);
@@ -0,0 +1,164 @@
+#include "bc/expected_task.h"
+
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Task_error { failed = 1 };
+
+// The same lazy task with symmetric transfer and frame recycling, reporting
+// errors as exceptions: the promise keeps a std::exception_ptr, and awaiting
+// the task rethrows it.
+template <class T>
+class exception_task {
+public:
+  struct promise_type : detail::frame_allocated {
+    exception_task get_return_object() noexcept {
+      return exception_task(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    auto final_suspend() noexcept {
+      struct awaiter {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<promise_type> h) noexcept {
+          if (h.promise().continuation)
+            return h.promise().continuation;
+          return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+      };
+      return awaiter{};
+    }
+    void return_value(T v) { value = std::move(v); }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    std::coroutine_handle<> continuation;
+    T value{};
+    std::exception_ptr error;
+  };
+
+  exception_task(exception_task&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  exception_task& operator=(exception_task&&) = delete;
+  ~exception_task() {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      bool await_ready() const noexcept { return false; }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<> caller) noexcept {
+        handle.promise().continuation = caller;
+        return handle;
+      }
+      T await_resume() {
+        if (handle.promise().error)
+          std::rethrow_exception(handle.promise().error);
+        return std::move(handle.promise().value);
+      }
+      std::coroutine_handle<promise_type> handle;
+    };
+    return awaiter{handle_};
+  }
+
+  // Runs a task that completes synchronously.
+  T get() {
+    handle_.resume();
+    if (handle_.promise().error)
+      std::rethrow_exception(handle_.promise().error);
+    return handle_.promise().value;
+  }
+
+private:
+  explicit exception_task(std::coroutine_handle<promise_type> h) noexcept
+      : handle_(h) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+constexpr int calls = 1000;
+
+// Three levels of tasks; the innermost one fails for percent of the calls.
+expected_task<int, Task_error> leaf(int i, int percent) {
+  if (i % 100 < percent)
+    co_return unexpected(Task_error::failed);
+  co_return i;
+}
+
+expected_task<int, Task_error> middle(int i, int percent) {
+  int x = co_await co_await leaf(i, percent);
+  co_return x + 1;
+}
+
+expected_task<int, Task_error> top(int i, int percent) {
+  int x = co_await co_await middle(i, percent);
+  co_return x + 1;
+}
+
+expected_task<int, Task_error> batch(int percent) {
+  int failures = 0;
+  for (int i = 0; i < calls; ++i) {
+    expected<int, Task_error> r = co_await top(i, percent);
+    failures += r.has_value() ? 0 : 1;
+  }
+  co_return failures;
+}
+
+exception_task<int> leaf_throw(int i, int percent) {
+  if (i % 100 < percent)
+    throw std::runtime_error("failed");
+  co_return i;
+}
+
+exception_task<int> middle_throw(int i, int percent) {
+  int x = co_await leaf_throw(i, percent);
+  co_return x + 1;
+}
+
+exception_task<int> top_throw(int i, int percent) {
+  int x = co_await middle_throw(i, percent);
+  co_return x + 1;
+}
+
+exception_task<int> batch_throw(int percent) {
+  int failures = 0;
+  for (int i = 0; i < calls; ++i) {
+    try {
+      co_await top_throw(i, percent);
+    } catch (const std::runtime_error&) {
+      ++failures;
+    }
+  }
+  co_return failures;
+}
+
+void expected_tasks(benchmark::State& state) {
+  const auto percent = static_cast<int>(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(sync_wait(batch(percent)));
+  state.SetItemsProcessed(state.iterations() * calls);
+}
+
+void exception_tasks(benchmark::State& state) {
+  const auto percent = static_cast<int>(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(batch_throw(percent).get());
+  state.SetItemsProcessed(state.iterations() * calls);
+}
+
+} // namespace
+
+// The argument is the percentage of calls that fail.
+BENCHMARK(expected_tasks)->Name("task/expected")->Arg(0)->Arg(10)->Arg(50);
+BENCHMARK(exception_tasks)->Name("task/exception")->Arg(0)->Arg(10)->Arg(50);
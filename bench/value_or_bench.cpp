@@ -0,0 +1,93 @@
+#include "bc/expected.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+using Vec = std::vector<int>;
+
+constexpr std::size_t default_size = 64;
+
+Vec make_default() {
+  return Vec(default_size, 1);
+}
+
+// The argument is the percentage of elements that hold an error.
+std::vector<expected<Vec, int>> make_input(benchmark::State& state) {
+  constexpr std::size_t size = 1024;
+  const auto error_percent = static_cast<std::size_t>(state.range(0));
+  std::vector<expected<Vec, int>> v;
+  v.reserve(size);
+  for (std::size_t i = 0; i != size; ++i) {
+    if (i % 100 < error_percent)
+      v.emplace_back(unexpect, 1);
+    else
+      v.emplace_back(std::in_place, 4, 1);
+  }
+  return v;
+}
+
+void value_or(benchmark::State& state) {
+  const auto v = make_input(state);
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    for (const auto& e : v)
+      sum += e.value_or(make_default()).size();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.size()));
+}
+
+void value_or_else(benchmark::State& state) {
+  const auto v = make_input(state);
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    for (const auto& e : v)
+      sum += e.value_or_else(make_default).size();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.size()));
+}
+
+void value_or_r_ref(benchmark::State& state) {
+  const auto input = make_input(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = input;
+    state.ResumeTiming();
+    std::size_t sum = 0;
+    for (auto& e : v)
+      sum += std::move(e).value_or(make_default()).size();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+void value_or_else_r_ref(benchmark::State& state) {
+  const auto input = make_input(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = input;
+    state.ResumeTiming();
+    std::size_t sum = 0;
+    for (auto& e : v)
+      sum += std::move(e).value_or_else(make_default).size();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(
+      static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+} // namespace
+
+BENCHMARK(value_or)->Arg(0)->Arg(1)->Arg(50)->Arg(100);
+BENCHMARK(value_or_else)->Arg(0)->Arg(1)->Arg(50)->Arg(100);
+BENCHMARK(value_or_r_ref)->Arg(0)->Arg(1)->Arg(50)->Arg(100);
+BENCHMARK(value_or_else_r_ref)->Arg(0)->Arg(1)->Arg(50)->Arg(100);
@@ -0,0 +1,85 @@
+#include "bc/when_all.h"
+
+#include <future>
+#include <tuple>
+
+#include <benchmark/benchmark.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Task_error { failed = 1 };
+
+using Result = expected<int, Task_error>;
+
+constexpr int fib_n = 14;
+
+Result leaf(int x) { return x + 1; }
+
+// Four tasks that each do almost nothing: the cost is the fan-out and join.
+void fan_out_pool(benchmark::State& state) {
+  work_stealing_pool pool;
+  for (auto _ : state) {
+    auto r = when_all(
+        pool, [] { return leaf(1); }, [] { return leaf(2); },
+        [] { return leaf(3); }, [] { return leaf(4); });
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetItemsProcessed(state.iterations() * 4);
+}
+
+void fan_out_async(benchmark::State& state) {
+  for (auto _ : state) {
+    auto f1 = std::async(std::launch::async, [] { return leaf(1); });
+    auto f2 = std::async(std::launch::async, [] { return leaf(2); });
+    auto f3 = std::async(std::launch::async, [] { return leaf(3); });
+    auto r4 = leaf(4);
+    auto r = std::make_tuple(f1.get(), f2.get(), f3.get(), r4);
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetItemsProcessed(state.iterations() * 4);
+}
+
+// Recursive fork-join with one task per call.
+Result fib_pool(work_stealing_pool& pool, int n) {
+  if (n < 2)
+    return n;
+  auto r = when_all(
+      pool, [&] { return fib_pool(pool, n - 1); },
+      [&] { return fib_pool(pool, n - 2); });
+  if (!r.has_value())
+    return unexpected(r.error());
+  return std::get<0>(*r) + std::get<1>(*r);
+}
+
+Result fib_async(int n) {
+  if (n < 2)
+    return n;
+  auto f = std::async(std::launch::async, [n] { return fib_async(n - 1); });
+  Result b = fib_async(n - 2);
+  Result a = f.get();
+  if (!a.has_value())
+    return a;
+  if (!b.has_value())
+    return b;
+  return *a + *b;
+}
+
+void fib_pool(benchmark::State& state) {
+  work_stealing_pool pool;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(fib_pool(pool, fib_n));
+}
+
+void fib_async(benchmark::State& state) {
+  for (auto _ : state)
+    benchmark::DoNotOptimize(fib_async(fib_n));
+}
+
+} // namespace
+
+BENCHMARK(fan_out_pool)->Name("when_all/fan_out_4/pool")->UseRealTime();
+BENCHMARK(fan_out_async)->Name("when_all/fan_out_4/async")->UseRealTime();
+BENCHMARK(fib_pool)->Name("when_all/fib/pool")->UseRealTime();
+BENCHMARK(fib_async)->Name("when_all/fib/async")->UseRealTime();
@@ -0,0 +1,380 @@
+#ifndef INCLUDE_BC_ATOMIC_EXPECTED_H
+#define INCLUDE_BC_ATOMIC_EXPECTED_H
+
+#include "bc/expected.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace bc {
+
+namespace detail {
+
+// Representation of an expected<T, E> as whole 8-byte words: the bytes of the
+// value or the error, then one byte that is 1 if there is a value. Unused and
+// padding bytes are zero, so that equal values have equal representations.
+template <class T, class E>
+struct atomic_expected_layout {
+  static constexpr std::size_t payload_size =
+      std::max(sizeof(std::conditional_t<std::is_void_v<T>, char, T>),
+               sizeof(E));
+  static constexpr std::size_t words = (payload_size + 1 + 7) / 8;
+
+  using bytes = std::array<unsigned char, words * 8>;
+
+  template <class U>
+  static void write(bytes& b, const U& obj) noexcept {
+    U copy = obj;
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_clear_padding)
+    __builtin_clear_padding(std::addressof(copy));
+#endif
+#endif
+    std::memcpy(b.data(), std::addressof(copy), sizeof(U));
+  }
+
+  template <class U>
+  static U read(const bytes& b) noexcept {
+    std::array<unsigned char, sizeof(U)> obj;
+    std::memcpy(obj.data(), b.data(), sizeof(U));
+    return std::bit_cast<U>(obj);
+  }
+
+  static bytes pack(const expected<T, E>& e) noexcept {
+    bytes b{};
+    if (e.has_value()) {
+      if constexpr (!std::is_void_v<T>)
+        write(b, *e);
+      b[payload_size] = 1;
+    } else {
+      write(b, e.error());
+    }
+    return b;
+  }
+
+  static expected<T, E> unpack(const bytes& b) noexcept {
+    if (b[payload_size] == 0)
+      return expected<T, E>(unexpect, read<E>(b));
+    if constexpr (std::is_void_v<T>)
+      return expected<T, E>();
+    else
+      return expected<T, E>(std::in_place, read<T>(b));
+  }
+};
+
+inline void spin_pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+// Storage of Words words with atomic load, store, exchange and compare
+// exchange. This is the fallback, a sequence lock: writers take the lock by
+// making the sequence number odd, and readers retry if it was odd or changed
+// while they read.
+template <std::size_t Words>
+struct atomic_words {
+  using bytes = std::array<unsigned char, Words * 8>;
+
+  static constexpr bool is_always_lock_free = false;
+
+  explicit atomic_words(const bytes& b) noexcept { write(b); }
+
+  bytes load(std::memory_order /*order*/) const noexcept {
+    for (;;) {
+      std::uint64_t seq = seq_.load(std::memory_order_acquire);
+      if (seq % 2 == 0) {
+        bytes b = read();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == seq)
+          return b;
+      }
+      spin_pause();
+    }
+  }
+
+  void store(const bytes& b, std::memory_order /*order*/) noexcept {
+    std::uint64_t seq = lock();
+    write(b);
+    unlock(seq);
+  }
+
+  bytes exchange(const bytes& b, std::memory_order /*order*/) noexcept {
+    std::uint64_t seq = lock();
+    bytes old = read();
+    write(b);
+    unlock(seq);
+    return old;
+  }
+
+  bool compare_exchange(bytes& expected_bytes, const bytes& desired,
+                        std::memory_order /*success*/,
+                        std::memory_order /*failure*/) noexcept {
+    std::uint64_t seq = lock();
+    bytes current = read();
+    bool equal = current == expected_bytes;
+    if (equal)
+      write(desired);
+    else
+      expected_bytes = current;
+    unlock(seq);
+    return equal;
+  }
+
+private:
+  std::uint64_t lock() noexcept {
+    std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+    for (;;) {
+      if (seq % 2 == 0 &&
+          seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                     std::memory_order_relaxed))
+        break;
+      spin_pause();
+      seq = seq_.load(std::memory_order_relaxed);
+    }
+    // Keeps the writes to the words after the sequence number becomes odd.
+    std::atomic_thread_fence(std::memory_order_release);
+    return seq + 1;
+  }
+
+  void unlock(std::uint64_t seq) noexcept {
+    seq_.store(seq + 1, std::memory_order_release);
+  }
+
+  bytes read() const noexcept {
+    std::array<std::uint64_t, Words> w;
+    for (std::size_t i = 0; i < Words; ++i)
+      w[i] = words_[i].load(std::memory_order_relaxed);
+    return std::bit_cast<bytes>(w);
+  }
+
+  void write(const bytes& b) noexcept {
+    auto w = std::bit_cast<std::array<std::uint64_t, Words>>(b);
+    for (std::size_t i = 0; i < Words; ++i)
+      words_[i].store(w[i], std::memory_order_relaxed);
+  }
+
+  std::atomic<std::uint64_t> seq_{0};
+  std::array<std::atomic<std::uint64_t>, Words> words_;
+};
+
+// One word: std::atomic<std::uint64_t>.
+template <>
+struct atomic_words<1> {
+  using bytes = std::array<unsigned char, 8>;
+
+  static constexpr bool is_always_lock_free =
+      std::atomic<std::uint64_t>::is_always_lock_free;
+
+  explicit atomic_words(const bytes& b) noexcept
+      : word_(std::bit_cast<std::uint64_t>(b)) {}
+
+  bytes load(std::memory_order order) const noexcept {
+    return std::bit_cast<bytes>(word_.load(order));
+  }
+
+  void store(const bytes& b, std::memory_order order) noexcept {
+    word_.store(std::bit_cast<std::uint64_t>(b), order);
+  }
+
+  bytes exchange(const bytes& b, std::memory_order order) noexcept {
+    return std::bit_cast<bytes>(
+        word_.exchange(std::bit_cast<std::uint64_t>(b), order));
+  }
+
+  bool compare_exchange(bytes& expected_bytes, const bytes& desired,
+                        std::memory_order success,
+                        std::memory_order failure) noexcept {
+    auto expected_word = std::bit_cast<std::uint64_t>(expected_bytes);
+    bool exchanged = word_.compare_exchange_strong(
+        expected_word, std::bit_cast<std::uint64_t>(desired), success,
+        failure);
+    expected_bytes = std::bit_cast<bytes>(expected_word);
+    return exchanged;
+  }
+
+private:
+  std::atomic<std::uint64_t> word_;
+};
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && defined(__AVX__)
+
+// Two words, with a 16-byte compare and swap (cmpxchg16b on x86-64 with
+// -mcx16). The __sync builtins are used because the __atomic ones call
+// libatomic for 16 bytes. They are full barriers, which satisfies any memory
+// order.
+//
+// Loads are a single aligned 16-byte move, which is atomic on processors with
+// AVX, so reading does not write to the cache line as a compare and swap
+// would. Without AVX the sequence lock is used instead.
+template <>
+struct atomic_words<2> {
+  __extension__ using word_type = unsigned __int128;
+  using bytes = std::array<unsigned char, 16>;
+
+  static constexpr bool is_always_lock_free = true;
+
+  explicit atomic_words(const bytes& b) noexcept
+      : word_(std::bit_cast<word_type>(b)) {}
+
+  // Loads on x86-64 are acquire; the clobber keeps the compiler from moving
+  // memory accesses across the load.
+  bytes load(std::memory_order /*order*/) const noexcept {
+    __m128i w;
+    __asm__ __volatile__("vmovdqa %1, %0" : "=x"(w) : "m"(word_) : "memory");
+    return std::bit_cast<bytes>(w);
+  }
+
+  void store(const bytes& b, std::memory_order order) noexcept {
+    exchange(b, order);
+  }
+
+  bytes exchange(const bytes& b, std::memory_order order) noexcept {
+    auto desired = std::bit_cast<word_type>(b);
+    auto old = std::bit_cast<word_type>(load(order));
+    for (;;) {
+      word_type current = __sync_val_compare_and_swap(&word_, old, desired);
+      if (current == old)
+        return std::bit_cast<bytes>(old);
+      old = current;
+    }
+  }
+
+  bool compare_exchange(bytes& expected_bytes, const bytes& desired,
+                        std::memory_order /*success*/,
+                        std::memory_order /*failure*/) noexcept {
+    auto expected_word = std::bit_cast<word_type>(expected_bytes);
+    word_type old = __sync_val_compare_and_swap(
+        &word_, expected_word, std::bit_cast<word_type>(desired));
+    expected_bytes = std::bit_cast<bytes>(old);
+    return old == expected_word;
+  }
+
+private:
+  alignas(16) word_type word_;
+};
+
+#endif
+
+} // namespace detail
+
+// An expected<T, E> that can be loaded, stored, exchanged and compared and
+// exchanged atomically. T (or void) and E must be trivially copyable. Lock-free
+// if the value or error plus one byte fits in 8 bytes, or in 16 bytes when the
+// target has a 16-byte compare and swap and atomic 16-byte loads (x86-64 with
+// -mcx16 and -mavx); a sequence lock otherwise. The sequence lock provides
+// acquire and release ordering whatever memory order is requested.
+//
+// Values are compared by their bytes, as std::atomic does. Padding inside T and
+// E is cleared when the compiler supports it.
+template <class T, class E>
+class atomic_expected {
+  static_assert(std::is_void_v<T> || std::is_trivially_copyable_v<T>);
+  static_assert(std::is_trivially_copyable_v<E>);
+
+  using layout = detail::atomic_expected_layout<T, E>;
+  using words = detail::atomic_words<layout::words>;
+
+public:
+  using value_type = expected<T, E>;
+
+  static constexpr bool is_always_lock_free = words::is_always_lock_free;
+
+  atomic_expected() noexcept : words_(layout::pack(value_type())) {}
+
+  // NOLINTNEXTLINE(*-explicit-constructor): Like std::atomic
+  atomic_expected(const value_type& desired) noexcept
+      : words_(layout::pack(desired)) {}
+
+  atomic_expected(const atomic_expected&) = delete;
+  atomic_expected& operator=(const atomic_expected&) = delete;
+
+  ~atomic_expected() = default;
+
+  atomic_expected& operator=(const value_type& desired) noexcept {
+    store(desired);
+    return *this;
+  }
+
+  // NOLINTNEXTLINE(*-explicit-constructor): Like std::atomic
+  operator value_type() const noexcept { return load(); }
+
+  bool is_lock_free() const noexcept { return is_always_lock_free; }
+
+  value_type load(
+      std::memory_order order = std::memory_order_seq_cst) const noexcept {
+    return layout::unpack(words_.load(order));
+  }
+
+  void store(const value_type& desired,
+             std::memory_order order = std::memory_order_seq_cst) noexcept {
+    words_.store(layout::pack(desired), order);
+  }
+
+  value_type exchange(
+      const value_type& desired,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return layout::unpack(words_.exchange(layout::pack(desired), order));
+  }
+
+  // Never fails spuriously; compare_exchange_weak is provided for symmetry
+  // with std::atomic.
+  bool compare_exchange_strong(value_type& expected_value,
+                               const value_type& desired,
+                               std::memory_order success,
+                               std::memory_order failure) noexcept {
+    auto expected_bytes = layout::pack(expected_value);
+    bool exchanged = words_.compare_exchange(
+        expected_bytes, layout::pack(desired), success, failure);
+    if (!exchanged)
+      expected_value = layout::unpack(expected_bytes);
+    return exchanged;
+  }
+
+  bool compare_exchange_strong(
+      value_type& expected_value, const value_type& desired,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return compare_exchange_strong(expected_value, desired, order,
+                                   failure_order(order));
+  }
+
+  bool compare_exchange_weak(value_type& expected_value,
+                             const value_type& desired,
+                             std::memory_order success,
+                             std::memory_order failure) noexcept {
+    return compare_exchange_strong(expected_value, desired, success, failure);
+  }
+
+  bool compare_exchange_weak(
+      value_type& expected_value, const value_type& desired,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return compare_exchange_strong(expected_value, desired, order,
+                                   failure_order(order));
+  }
+
+private:
+  static constexpr std::memory_order failure_order(std::memory_order order) {
+    if (order == std::memory_order_acq_rel)
+      return std::memory_order_acquire;
+    if (order == std::memory_order_release)
+      return std::memory_order_relaxed;
+    return order;
+  }
+
+  words words_;
+};
+
+} // namespace bc
+
+#endif
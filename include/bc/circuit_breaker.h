@@ -0,0 +1,332 @@
+#ifndef INCLUDE_BC_CIRCUIT_BREAKER_H
+#define INCLUDE_BC_CIRCUIT_BREAKER_H
+
+#include "bc/expected.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace bc {
+
+enum class circuit_state {
+  // Calls go through, and their results are counted.
+  closed,
+  // Calls fail with the breaker's error without being made.
+  open,
+  // One call, the probe, goes through; the others fail as when open.
+  half_open,
+};
+
+struct circuit_breaker_options {
+  using duration = std::chrono::nanoseconds;
+
+  // The breaker opens when, over the last window, at least min_calls were
+  // made and at least failure_rate of them failed.
+  double failure_rate = 0.5;
+  std::size_t min_calls = 20;
+  duration window = std::chrono::seconds(10);
+  // The window slides by window / buckets at a time. Rounded up to a power of
+  // two.
+  std::size_t buckets = 8;
+  // How long the breaker stays open before it lets a probe through.
+  duration open_duration = std::chrono::seconds(5);
+};
+
+namespace detail {
+
+// Threads are spread over the stripes of counters in turn.
+inline std::size_t breaker_stripe() noexcept {
+  static std::atomic<std::size_t> next{0};
+  thread_local const std::size_t stripe =
+      next.fetch_add(1, std::memory_order_relaxed);
+  return stripe;
+}
+
+} // namespace detail
+
+// Protects a dependency that fails: once too many of the calls made through the
+// breaker fail, it opens, and calls fail at once with open_error rather than
+// being made. After open_duration one call is let through as a probe, and its
+// result closes the breaker again or keeps it open.
+//
+//   bc::circuit_breaker<Db_error> breaker(Db_error::unavailable);
+//   auto rows = breaker.call([&] { return db.query(sql); });
+//
+// The window is a ring of buckets of failure and success counts, indexed by
+// time, and striped by thread so that threads do not contend on one counter.
+// While closed, a call costs a relaxed load of the state and a relaxed add to
+// a counter. Successes are added to a pending count of the stripe rather than
+// to a bucket, since without reading the clock a call cannot tell whether the
+// current bucket is still current. The clock is read on failures and on every
+// 64th success of a stripe, to slide the window; a slide moves the pending
+// successes to the new current bucket. So the window is approximate: a
+// success may be kept until up to 64 later successes of its stripe.
+//
+// An exception that escapes the callable is not counted. Clock needs a now()
+// member; it can be replaced in tests.
+template <class E, class Clock = std::chrono::steady_clock>
+class circuit_breaker {
+public:
+  using error_type = E;
+
+  explicit circuit_breaker(E open_error,
+                           circuit_breaker_options options = {},
+                           Clock clock = Clock())
+      : open_error_(std::move(open_error)), options_(options),
+        clock_(std::move(clock)),
+        buckets_(std::bit_ceil(std::max(options.buckets, std::size_t{1}))),
+        bucket_width_(std::max(options.window.count() /
+                                   static_cast<std::int64_t>(buckets_),
+                               std::int64_t{1})),
+        // The pending successes come after the buckets.
+        lines_per_stripe_((buckets_ + line_counters) / line_counters),
+        lines_(std::make_unique<line[]>(stripes * lines_per_stripe_)),
+        control_(epoch_of(clock_.now()) << state_bits) {}
+
+  circuit_breaker(const circuit_breaker&) = delete;
+  circuit_breaker& operator=(const circuit_breaker&) = delete;
+
+  ~circuit_breaker() = default;
+
+  // Calls f, which returns an expected<T, E>, unless the breaker is open.
+  template <class F>
+  std::invoke_result_t<F&> call(F&& f) {
+    using R = std::invoke_result_t<F&>;
+    static_assert(std::is_same_v<typename R::error_type, E>);
+    if (state() != circuit_state::closed) [[unlikely]]
+      return call_not_closed<R>(f);
+    R r = std::invoke(f);
+    if (r.has_value()) [[likely]] {
+      const std::uint64_t before =
+          pending(detail::breaker_stripe())
+              .fetch_add(success, std::memory_order_relaxed);
+      if ((before & tick_mask) == tick_mask) [[unlikely]]
+        tick();
+    } else {
+      record_failure();
+    }
+    return r;
+  }
+
+  circuit_state state() const noexcept {
+    return state_of(control_.load(std::memory_order_relaxed));
+  }
+
+  const E& open_error() const noexcept { return open_error_; }
+
+private:
+  static constexpr int state_bits = 2;
+  static constexpr std::uint64_t state_mask = (1U << state_bits) - 1;
+  // Successes in the low half of a counter, failures in the high half.
+  static constexpr std::uint64_t success = 1;
+  static constexpr std::uint64_t failure = std::uint64_t{1} << 32;
+  static constexpr std::uint64_t tick_mask = 63;
+  static constexpr std::size_t stripes = 8;
+  static constexpr std::size_t cache_line = 64;
+  static constexpr std::size_t line_counters =
+      cache_line / sizeof(std::atomic<std::uint64_t>);
+
+  struct alignas(cache_line) line {
+    std::array<std::atomic<std::uint64_t>, line_counters> counters{};
+  };
+
+  // Lets a probe that threw be followed by another one later.
+  struct probe_guard {
+    explicit probe_guard(circuit_breaker* b) noexcept : breaker(b) {}
+    probe_guard(const probe_guard&) = delete;
+    probe_guard& operator=(const probe_guard&) = delete;
+
+    ~probe_guard() {
+      if (breaker != nullptr)
+        breaker->reopen();
+    }
+
+    circuit_breaker* breaker;
+  };
+
+  static circuit_state state_of(std::uint64_t c) noexcept {
+    return static_cast<circuit_state>(c & state_mask);
+  }
+
+  static std::uint64_t with_state(std::uint64_t c, circuit_state s) noexcept {
+    return (c & ~state_mask) | static_cast<std::uint64_t>(s);
+  }
+
+  std::int64_t nanoseconds_of(typename Clock::time_point t) const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               t.time_since_epoch())
+        .count();
+  }
+
+  std::uint64_t epoch_of(typename Clock::time_point t) const {
+    return static_cast<std::uint64_t>(nanoseconds_of(t) / bucket_width_);
+  }
+
+  std::size_t bucket_of(std::uint64_t c) const noexcept {
+    return static_cast<std::size_t>(c >> state_bits) & (buckets_ - 1);
+  }
+
+  std::atomic<std::uint64_t>& counter(std::size_t stripe,
+                                      std::size_t bucket) noexcept {
+    return lines_[(stripe % stripes) * lines_per_stripe_ +
+                  bucket / line_counters]
+        .counters[bucket % line_counters];
+  }
+
+  std::atomic<std::uint64_t>& pending(std::size_t stripe) noexcept {
+    return counter(stripe, buckets_);
+  }
+
+  // Also clears the pending successes, as bucket buckets_.
+  void clear_bucket(std::size_t bucket) noexcept {
+    for (std::size_t s = 0; s < stripes; ++s)
+      counter(s, bucket).store(0, std::memory_order_relaxed);
+  }
+
+  // Moves the window to the bucket of epoch, then moves the pending successes
+  // to it. One thread slides at a time; the others give up. The buckets passed
+  // are cleared before the new epoch is published, so that a failure counted
+  // in the new current bucket is never cleared.
+  void slide(std::uint64_t epoch) {
+    if (epoch <= control_.load(std::memory_order_relaxed) >> state_bits ||
+        sliding_.exchange(true, std::memory_order_acquire))
+      return;
+    std::uint64_t c = control_.load(std::memory_order_relaxed);
+    const std::uint64_t current = c >> state_bits;
+    if (epoch > current) {
+      const std::uint64_t passed = std::min<std::uint64_t>(epoch - current,
+                                                           buckets_);
+      for (std::uint64_t e = epoch - passed + 1; e <= epoch; ++e)
+        clear_bucket(static_cast<std::size_t>(e) & (buckets_ - 1));
+      // Only the state can change meanwhile.
+      while (!control_.compare_exchange_weak(
+          c, (epoch << state_bits) | (c & state_mask),
+          std::memory_order_release, std::memory_order_relaxed)) {
+      }
+      const std::size_t b = static_cast<std::size_t>(epoch) & (buckets_ - 1);
+      for (std::size_t s = 0; s < stripes; ++s) {
+        if (const std::uint64_t n =
+                pending(s).exchange(0, std::memory_order_relaxed))
+          counter(s, b).fetch_add(n, std::memory_order_relaxed);
+      }
+    }
+    sliding_.store(false, std::memory_order_release);
+  }
+
+  void tick() { slide(epoch_of(clock_.now())); }
+
+  // Slides the window before counting the failure, and waits for a slide by
+  // another thread, so that the failure is counted in the current bucket
+  // rather than one about to be cleared.
+  [[gnu::noinline]] void record_failure() {
+    const auto now = clock_.now();
+    slide(epoch_of(now));
+    while (sliding_.load(std::memory_order_acquire))
+      std::this_thread::yield();
+    std::uint64_t c = control_.load(std::memory_order_relaxed);
+    counter(detail::breaker_stripe(), bucket_of(c))
+        .fetch_add(failure, std::memory_order_relaxed);
+
+    std::uint64_t successes = 0;
+    std::uint64_t failures = 0;
+    for (std::size_t s = 0; s < stripes; ++s) {
+      for (std::size_t b = 0; b <= buckets_; ++b) {
+        const std::uint64_t n = counter(s, b).load(std::memory_order_relaxed);
+        successes += n & (failure - 1);
+        failures += n >> 32;
+      }
+    }
+    const std::uint64_t calls = successes + failures;
+    if (calls < options_.min_calls ||
+        static_cast<double>(failures) <
+            options_.failure_rate * static_cast<double>(calls))
+      return;
+
+    opened_at_.store(nanoseconds_of(now), std::memory_order_relaxed);
+    c = control_.load(std::memory_order_relaxed);
+    while (state_of(c) == circuit_state::closed &&
+           !control_.compare_exchange_weak(c,
+                                           with_state(c, circuit_state::open),
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+  }
+
+  void set_state(circuit_state s) noexcept {
+    std::uint64_t c = control_.load(std::memory_order_relaxed);
+    while (!control_.compare_exchange_weak(c, with_state(c, s),
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+  }
+
+  void reopen() {
+    opened_at_.store(nanoseconds_of(clock_.now()), std::memory_order_relaxed);
+    set_state(circuit_state::open);
+  }
+
+  void close() {
+    for (std::size_t b = 0; b <= buckets_; ++b)
+      clear_bucket(b);
+    set_state(circuit_state::closed);
+    tick();
+  }
+
+  template <class R, class F>
+  [[gnu::noinline]] R call_not_closed(F& f) {
+    std::uint64_t c = control_.load(std::memory_order_acquire);
+    switch (state_of(c)) {
+    case circuit_state::closed:
+      return call(f);
+    case circuit_state::half_open:
+      return R(unexpect, open_error_);
+    case circuit_state::open:
+      break;
+    }
+    const std::int64_t open_for =
+        nanoseconds_of(clock_.now()) -
+        opened_at_.load(std::memory_order_relaxed);
+    if (open_for < options_.open_duration.count() ||
+        !control_.compare_exchange_strong(
+            c, with_state(c, circuit_state::half_open),
+            std::memory_order_acquire, std::memory_order_relaxed))
+      return R(unexpect, open_error_);
+
+    probe_guard guard(this);
+    R r = std::invoke(f);
+    guard.breaker = nullptr;
+    if (r.has_value())
+      close();
+    else
+      reopen();
+    return r;
+  }
+
+  E open_error_;
+  circuit_breaker_options options_;
+  Clock clock_;
+  std::size_t buckets_;
+  std::int64_t bucket_width_;
+  std::size_t lines_per_stripe_;
+  std::unique_ptr<line[]> lines_;
+  // The epoch of the current bucket, above the state.
+  std::atomic<std::uint64_t> control_;
+  // Held by the thread that slides the window.
+  std::atomic<bool> sliding_{false};
+  // In nanoseconds since the epoch of Clock.
+  std::atomic<std::int64_t> opened_at_{0};
+};
+
+} // namespace bc
+
+#endif
@@ -0,0 +1,38 @@
+// Module interface unit of bc.expected. Exports the API of bc/expected.h.
+//
+// Macros are not exported: BC_STD_EXPECTED_ACCESS_CHECK and
+// BC_STD_EXPECTED_NO_EXCEPTIONS take effect when this unit is compiled, and
+// importers that need the version macros include the header instead.
+
+module;
+
+#include "bc/expected.h"
+
+export module bc.expected;
+
+export namespace bc {
+
+using bc::expected;
+using bc::unexpected;
+
+using bc::unexpect;
+using bc::unexpect_t;
+
+using bc::in_place_invoke;
+using bc::in_place_invoke_t;
+using bc::unexpect_invoke;
+using bc::unexpect_invoke_t;
+
+using bc::bad_expected_access;
+using bc::bad_expected_access_handler;
+using bc::get_bad_expected_access_handler;
+using bc::set_bad_expected_access_handler;
+
+using bc::is_trivially_relocatable;
+using bc::is_trivially_relocatable_v;
+
+using bc::operator==;
+using bc::operator!=;
+using bc::swap;
+
+} // namespace bc
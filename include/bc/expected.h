@@ -6,12 +6,72 @@
 #define BC_STD_EXPECTED_VERSION_MINOR 3
 // NOLINTEND(*-macro-usage): Version
 
+// NOLINTBEGIN(*-macro-usage): Configuration
+// BC_STD_EXPECTED_NO_EXCEPTIONS is defined when exceptions are disabled. It can
+// also be defined by the user to opt out of exceptions explicitly. In that mode
+// value() reports an error through the bad expected access handler instead of
+// throwing. The rollback paths of assignment, emplace and swap only depend on
+// whether exceptions are enabled, since the constructors of T and E may still
+// throw when the user defines the macro.
+#if !defined(BC_STD_EXPECTED_NO_EXCEPTIONS) && !defined(__cpp_exceptions)
+#define BC_STD_EXPECTED_NO_EXCEPTIONS
+#endif
+
+#ifndef __cpp_exceptions
+#define BC_STD_EXPECTED_TRY if constexpr (true)
+#define BC_STD_EXPECTED_CATCH_ALL else
+#define BC_STD_EXPECTED_RETHROW static_cast<void>(0)
+#else
+#define BC_STD_EXPECTED_TRY try
+#define BC_STD_EXPECTED_CATCH_ALL catch (...)
+#define BC_STD_EXPECTED_RETHROW throw
+#endif
+
+// BC_STD_EXPECTED_ACCESS_CHECK selects how operator->, operator* and error()
+// check that the accessed member is active:
+// - BC_STD_EXPECTED_ACCESS_UNCHECKED: No check. Default if NDEBUG is defined.
+// - BC_STD_EXPECTED_ACCESS_ASSERT: Print the failed check and abort.
+//   Default if NDEBUG is not defined.
+// - BC_STD_EXPECTED_ACCESS_TRAP: Execute a trap instruction. Intended for
+//   hardened release builds.
+// Every translation unit of a program must use the same level.
+#define BC_STD_EXPECTED_ACCESS_UNCHECKED 0
+#define BC_STD_EXPECTED_ACCESS_ASSERT 1
+#define BC_STD_EXPECTED_ACCESS_TRAP 2
+
+#ifndef BC_STD_EXPECTED_ACCESS_CHECK
+#ifdef NDEBUG
+#define BC_STD_EXPECTED_ACCESS_CHECK BC_STD_EXPECTED_ACCESS_UNCHECKED
+#else
+#define BC_STD_EXPECTED_ACCESS_CHECK BC_STD_EXPECTED_ACCESS_ASSERT
+#endif
+#endif
+
+// BC_STD_EXPECTED_EXTERN_TEMPLATES declares the instantiations of expected for
+// common types as extern templates. It is defined by the
+// bcexpected_instantiations library, which provides their definitions and
+// must be built with the same configuration.
+// NOLINTEND(*-macro-usage): Configuration
+
+#include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <initializer_list>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
+#if BC_STD_EXPECTED_ACCESS_CHECK == BC_STD_EXPECTED_ACCESS_ASSERT
+#include <cstdio>
+#endif
+
+#ifdef BC_STD_EXPECTED_EXTERN_TEMPLATES
+#include <cstddef>
+#include <string>
+#include <system_error>
+#endif
+
 namespace bc {
 
 // NOLINTBEGIN(*-pro-type-union-access): Tagged union
@@ -27,6 +87,21 @@ struct unexpect_t {
 
 inline constexpr unexpect_t unexpect{};
 
+// Constructs the value (in_place_invoke) or the error (unexpect_invoke) from
+// the result of invoking a callable. A prvalue result initializes the member
+// directly, so the type need not be copyable or movable.
+struct in_place_invoke_t {
+  explicit in_place_invoke_t() = default;
+};
+
+inline constexpr in_place_invoke_t in_place_invoke{};
+
+struct unexpect_invoke_t {
+  explicit unexpect_invoke_t() = default;
+};
+
+inline constexpr unexpect_invoke_t unexpect_invoke{};
+
 template <class E>
 class bad_expected_access;
 
@@ -52,8 +127,76 @@ private:
   E val_;
 };
 
+// Called instead of throwing when exceptions are disabled. The handler must
+// not return; std::abort() is called if it does, or if no handler is set.
+using bad_expected_access_handler = void (*)(const bad_expected_access<void>&);
+
 namespace detail {
 
+// Not synchronized; install the handler before starting other threads.
+inline bad_expected_access_handler bad_access_handler = nullptr;
+
+} // namespace detail
+
+inline bad_expected_access_handler
+set_bad_expected_access_handler(bad_expected_access_handler handler) noexcept {
+  return std::exchange(detail::bad_access_handler, handler);
+}
+
+inline bad_expected_access_handler get_bad_expected_access_handler() noexcept {
+  return detail::bad_access_handler;
+}
+
+namespace detail {
+
+inline constexpr bool exceptions_enabled =
+#ifndef __cpp_exceptions
+    false;
+#else
+    true;
+#endif
+
+template <class E>
+[[noreturn]] void throw_bad_expected_access(E&& e) {
+#ifdef BC_STD_EXPECTED_NO_EXCEPTIONS
+  if (bad_expected_access_handler handler = bad_access_handler)
+    handler(bad_expected_access<std::decay_t<E>>(std::forward<E>(e)));
+  std::abort();
+#else
+  throw bad_expected_access<std::decay_t<E>>(std::forward<E>(e));
+#endif
+}
+
+inline constexpr int access_check = BC_STD_EXPECTED_ACCESS_CHECK;
+
+static_assert(access_check == BC_STD_EXPECTED_ACCESS_UNCHECKED ||
+              access_check == BC_STD_EXPECTED_ACCESS_ASSERT ||
+              access_check == BC_STD_EXPECTED_ACCESS_TRAP);
+
+#if BC_STD_EXPECTED_ACCESS_CHECK == BC_STD_EXPECTED_ACCESS_ASSERT
+// Operators cannot take a defaulted std::source_location, so the message does
+// not say where the access was made; the backtrace of the abort does.
+[[noreturn]] inline void access_check_failed(const char* expr) {
+  // NOLINTNEXTLINE(*-pro-type-vararg): Avoids <iostream>
+  std::fprintf(stderr, "bc::expected: Access check `%s' failed.\n", expr);
+  std::abort();
+}
+#endif
+
+// Preprocessed rather than if constexpr, so that <cstdio> is only included at
+// the level that prints.
+constexpr void check_access([[maybe_unused]] bool ok,
+                            [[maybe_unused]] const char* expr) {
+#if BC_STD_EXPECTED_ACCESS_CHECK == BC_STD_EXPECTED_ACCESS_ASSERT
+  if (!ok) [[unlikely]]
+    access_check_failed(expr);
+#elif BC_STD_EXPECTED_ACCESS_CHECK == BC_STD_EXPECTED_ACCESS_TRAP
+  if (ok) [[likely]]
+    return;
+  __builtin_trap();
+#endif
+}
+
 template <class E, class Err>
 using is_constructible_from_unexpected =
     std::disjunction<std::is_constructible<E, unexpected<Err>&>,
@@ -65,6 +208,49 @@ using is_constructible_from_unexpected =
                      std::is_convertible<const unexpected<Err>&, E>,
                      std::is_convertible<const unexpected<Err>&&, E>>;
 
+template <class F, class... Args>
+using call_result_t = decltype(std::declval<F>()(std::declval<Args>()...));
+
+// Whether T can be constructed from the result of calling F with Args. If the
+// result is a prvalue T the construction needs neither copy nor move.
+template <class Void, class T, class F, class... Args>
+struct invoke_construction {
+  static constexpr bool constructible = false;
+  static constexpr bool nothrow_constructible = false;
+};
+
+template <class T, class F, class... Args>
+struct invoke_construction<std::void_t<call_result_t<F, Args...>>, T, F,
+                           Args...> {
+  using result_type = call_result_t<F, Args...>;
+
+  static constexpr bool elided =
+      std::is_same_v<std::remove_cv_t<result_type>, T>;
+  static constexpr bool constructible =
+      elided || std::is_constructible_v<T, result_type>;
+  static constexpr bool nothrow_constructible =
+      noexcept(std::declval<F>()(std::declval<Args>()...)) &&
+      (elided || std::is_nothrow_constructible_v<T, result_type>);
+};
+
+template <class T, class F, class... Args>
+inline constexpr bool is_invoke_constructible_v =
+    invoke_construction<void, T, F, Args...>::constructible;
+
+template <class T, class F, class... Args>
+inline constexpr bool is_nothrow_invoke_constructible_v =
+    invoke_construction<void, T, F, Args...>::nothrow_constructible;
+
+// Converts to the result of calling f. Passing it to std::construct_at
+// initializes the object directly from that result, without a copy or move.
+template <class F>
+struct invoke_elider {
+  F& f;
+
+  // NOLINTNEXTLINE(*-explicit-conversions): Converted by std::construct_at
+  constexpr operator call_result_t<F&>() const { return f(); }
+};
+
 template <class E, class Err, class Err_qualified>
 using enable_unexpected_unexpected_constructor =
     std::enable_if_t<std::is_constructible_v<E, Err_qualified> &&
@@ -132,6 +318,12 @@ public:
                                 Args&&... args)
       : val_(il, std::forward<Args>(args)...) {}
 
+  template <class F, class... Args,
+            std::enable_if_t<detail::is_invoke_constructible_v<
+                E, F&&, Args&&...>>* = nullptr>
+  constexpr explicit unexpected(in_place_invoke_t, F&& f, Args&&... args)
+      : val_(std::forward<F>(f)(std::forward<Args>(args)...)) {}
+
   ~unexpected() = default;
 
   constexpr unexpected& operator=(const unexpected&) = default;
@@ -158,7 +350,8 @@ public:
   constexpr E&& value() && noexcept { return std::move(val_); }
 
   template <class E1 = E, std::enable_if_t<std::is_swappable_v<E1>>* = nullptr>
-  void swap(unexpected& other) noexcept(std::is_nothrow_swappable_v<E>) {
+  constexpr void swap(unexpected& other) noexcept(
+      std::is_nothrow_swappable_v<E>) {
     using std::swap;
     swap(val_, other.val_);
   }
@@ -181,10 +374,50 @@ constexpr bool operator!=(const unexpected<E1>& x, const unexpected<E2>& y) {
 }
 
 template <class E, std::enable_if_t<std::is_swappable_v<E>>* = nullptr>
-void swap(unexpected<E>& x, unexpected<E>& y) noexcept(noexcept(x.swap(y))) {
+constexpr void swap(unexpected<E>& x,
+                    unexpected<E>& y) noexcept(noexcept(x.swap(y))) {
   x.swap(y);
 }
 
+// A type is trivially relocatable if moving an object to a new address and
+// destroying the source is equivalent to copying its bytes. Assignment and
+// swap of expected use memcpy instead of move construction, destruction and
+// rollback when the alternatives involved are trivially relocatable.
+// Specialize for user-defined types to opt in; the type must not store
+// pointers into itself or register its address anywhere.
+template <class T>
+struct is_trivially_relocatable
+    : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
+template <class T, class D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>>
+    : std::bool_constant<is_trivially_relocatable_v<
+                             typename std::unique_ptr<T, D>::pointer> &&
+                         is_trivially_relocatable_v<D>> {};
+
+template <class T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <class T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+// std::string of libstdc++ points into its own buffer when the string is short,
+// so it is not trivially relocatable. bc/relocatable_vector.h opts in
+// std::vector, so that this header need not include <vector>.
+
+template <class E>
+struct is_trivially_relocatable<unexpected<E>> : is_trivially_relocatable<E> {
+};
+
+template <class T, class E>
+struct is_trivially_relocatable<expected<T, E>>
+    : std::bool_constant<(std::is_void_v<T> || is_trivially_relocatable_v<T>) &&
+                         is_trivially_relocatable_v<E>> {};
+
 namespace detail {
 
 template <class T>
@@ -337,21 +570,15 @@ struct uninit_t {
 
 inline constexpr uninit_t uninit{};
 
-// Storage of values. Trivially destructible if both T and E are.
-// clang-format off
-template <class T, class E,
-          bool = is_trivially_destructible_or_void_v<T> &&
-                 std::is_trivially_destructible_v<E>>
-struct expected_storage_base;
-// clang-format on
-
-// Either T, E or both are not trivially destructible.
+// Storage of values. Trivially destructible if both T and E are. The copy and
+// move operations are trivial if those of T and E are, and deleted otherwise;
+// expected provides the non-trivial ones.
 template <class T, class E>
-struct expected_storage_base<T, E, false> {
+struct expected_storage_base {
   constexpr expected_storage_base() : val_(), has_val_(true) {}
 
-  expected_storage_base(const expected_storage_base&) = delete;
-  expected_storage_base(expected_storage_base&&) = delete;
+  expected_storage_base(const expected_storage_base&) = default;
+  expected_storage_base(expected_storage_base&&) = default;
 
   constexpr explicit expected_storage_base(uninit_t)
       : uninit_(), has_val_(false) {}
@@ -369,6 +596,14 @@ struct expected_storage_base<T, E, false> {
                                            Args&&... args)
       : val_(il, std::forward<Args>(args)...), has_val_(true) {}
 
+  template <class F, class... Args,
+            std::enable_if_t<
+                is_invoke_constructible_v<T, F&&, Args&&...>>* = nullptr>
+  constexpr explicit expected_storage_base(in_place_invoke_t, F&& f,
+                                           Args&&... args)
+      : val_(std::forward<F>(f)(std::forward<Args>(args)...)),
+        has_val_(true) {}
+
   template <class... Args,
             std::enable_if_t<std::is_constructible_v<E, Args&&...>>* = nullptr>
   constexpr explicit expected_storage_base(unexpect_t, Args&&... args)
@@ -384,7 +619,21 @@ struct expected_storage_base<T, E, false> {
       : unexpect_(std::in_place, il, std::forward<Args>(args)...),
         has_val_(false) {}
 
-  ~expected_storage_base() {
+  template <class F, class... Args,
+            std::enable_if_t<
+                is_invoke_constructible_v<E, F&&, Args&&...>>* = nullptr>
+  constexpr explicit expected_storage_base(unexpect_invoke_t, F&& f,
+                                           Args&&... args)
+      : unexpect_(in_place_invoke, std::forward<F>(f),
+                  std::forward<Args>(args)...),
+        has_val_(false) {}
+
+  ~expected_storage_base()
+    requires(std::is_trivially_destructible_v<T> &&
+             std::is_trivially_destructible_v<E>)
+  = default;
+
+  constexpr ~expected_storage_base() {
     if (has_val_) {
       if constexpr (!std::is_trivially_destructible_v<T>)
         val_.~T();
@@ -394,58 +643,6 @@ struct expected_storage_base<T, E, false> {
     }
   }
 
-  expected_storage_base& operator=(const expected_storage_base&) = delete;
-  expected_storage_base& operator=(expected_storage_base&&) = delete;
-
-  union {
-    T val_;
-    unexpected<E> unexpect_;
-    char uninit_;
-  };
-  bool has_val_;
-};
-
-// Both T and E are trivially destructible.
-template <class T, class E>
-struct expected_storage_base<T, E, true> {
-  constexpr expected_storage_base() : val_(), has_val_(true) {}
-
-  expected_storage_base(const expected_storage_base&) = default;
-  expected_storage_base(expected_storage_base&&) = default;
-
-  constexpr explicit expected_storage_base(uninit_t)
-      : uninit_(), has_val_(false) {}
-
-  template <class... Args,
-            std::enable_if_t<std::is_constructible_v<T, Args&&...>>* = nullptr>
-  constexpr explicit expected_storage_base(std::in_place_t, Args&&... args)
-      : val_(std::forward<Args>(args)...), has_val_(true) {}
-
-  template <class U, class... Args,
-            std::enable_if_t<std::is_constructible_v<
-                T, std::initializer_list<U>&, Args&&...>>* = nullptr>
-  constexpr explicit expected_storage_base(std::in_place_t,
-                                           std::initializer_list<U> il,
-                                           Args&&... args)
-      : val_(il, std::forward<Args>(args)...), has_val_(true) {}
-
-  template <class... Args,
-            std::enable_if_t<std::is_constructible_v<E, Args&&...>>* = nullptr>
-  constexpr explicit expected_storage_base(unexpect_t, Args&&... args)
-      : unexpect_(std::in_place, std::forward<Args>(args)...),
-        has_val_(false) {}
-
-  template <class U, class... Args,
-            std::enable_if_t<std::is_constructible_v<
-                E, std::initializer_list<U>&, Args&&...>>* = nullptr>
-  constexpr explicit expected_storage_base(unexpect_t,
-                                           std::initializer_list<U> il,
-                                           Args&&... args)
-      : unexpect_(std::in_place, il, std::forward<Args>(args)...),
-        has_val_(false) {}
-
-  ~expected_storage_base() = default;
-
   expected_storage_base& operator=(const expected_storage_base&) = default;
   expected_storage_base& operator=(expected_storage_base&&) = default;
 
@@ -457,13 +654,13 @@ struct expected_storage_base<T, E, true> {
   bool has_val_;
 };
 
-// T is void, E is not trivially destructible.
+// T is void.
 template <class E>
-struct expected_storage_base<void, E, false> {
+struct expected_storage_base<void, E> {
   constexpr expected_storage_base() : dummy_(), has_val_(true) {}
 
-  expected_storage_base(const expected_storage_base&) = delete;
-  expected_storage_base(expected_storage_base&&) = delete;
+  expected_storage_base(const expected_storage_base&) = default;
+  expected_storage_base(expected_storage_base&&) = default;
 
   constexpr explicit expected_storage_base(uninit_t)
       : uninit_(), has_val_(false) {}
@@ -486,14 +683,27 @@ struct expected_storage_base<void, E, false> {
       : unexpect_(std::in_place, il, std::forward<Args>(args)...),
         has_val_(false) {}
 
-  ~expected_storage_base() {
+  template <class F, class... Args,
+            std::enable_if_t<
+                is_invoke_constructible_v<E, F&&, Args&&...>>* = nullptr>
+  constexpr explicit expected_storage_base(unexpect_invoke_t, F&& f,
+                                           Args&&... args)
+      : unexpect_(in_place_invoke, std::forward<F>(f),
+                  std::forward<Args>(args)...),
+        has_val_(false) {}
+
+  ~expected_storage_base()
+    requires std::is_trivially_destructible_v<E>
+  = default;
+
+  constexpr ~expected_storage_base() {
     if (!has_val_) {
       unexpect_.~unexpected<E>();
     }
   }
 
-  expected_storage_base& operator=(const expected_storage_base&) = delete;
-  expected_storage_base& operator=(expected_storage_base&&) = delete;
+  expected_storage_base& operator=(const expected_storage_base&) = default;
+  expected_storage_base& operator=(expected_storage_base&&) = default;
 
   struct dummy {};
   union {
@@ -504,47 +714,36 @@ struct expected_storage_base<void, E, false> {
   bool has_val_;
 };
 
-// T is void, E is trivially destructible.
-template <class E>
-struct expected_storage_base<void, E, true> {
-  constexpr expected_storage_base() : dummy_(), has_val_(true) {}
-
-  expected_storage_base(const expected_storage_base&) = default;
-  expected_storage_base(expected_storage_base&&) = default;
-
-  constexpr explicit expected_storage_base(uninit_t)
-      : uninit_(), has_val_(false) {}
-
-  constexpr explicit expected_storage_base(std::in_place_t)
-      : dummy_(), has_val_(true) {}
-
-  template <class... Args,
-            std::enable_if_t<std::is_constructible_v<E, Args&&...>>* = nullptr>
-  constexpr explicit expected_storage_base(unexpect_t, Args&&... args)
-      : unexpect_(std::in_place, std::forward<Args>(args)...),
-        has_val_(false) {}
+// Copies the bytes of src to the storage of dst. Only valid for trivially
+// relocatable types: src is no longer alive afterwards and must not be
+// destroyed, and dst must not be alive before.
+template <class U>
+void relocate(U& dst, U& src) noexcept {
+  std::memcpy(static_cast<void*>(std::addressof(dst)),
+              static_cast<const void*>(std::addressof(src)), sizeof(U));
+}
 
-  template <class U, class... Args,
-            std::enable_if_t<std::is_constructible_v<
-                E, std::initializer_list<U>&, Args&&...>>* = nullptr>
-  constexpr explicit expected_storage_base(unexpect_t,
-                                           std::initializer_list<U> il,
-                                           Args&&... args)
-      : unexpect_(std::in_place, il, std::forward<Args>(args)...),
-        has_val_(false) {}
+// Holds a trivially relocatable object that was moved out of an expected while
+// the other alternative is constructed in its place, so that it can be moved
+// back without running a constructor if that construction throws.
+template <class U>
+struct relocation_buffer {
+  void relocate_from(U& obj) noexcept {
+    std::memcpy(bytes_, static_cast<const void*>(std::addressof(obj)),
+                sizeof(U));
+  }
 
-  ~expected_storage_base() = default;
+  void relocate_to(U& obj) noexcept {
+    std::memcpy(static_cast<void*>(std::addressof(obj)), bytes_, sizeof(U));
+  }
 
-  expected_storage_base& operator=(const expected_storage_base&) = default;
-  expected_storage_base& operator=(expected_storage_base&&) = default;
+  void destroy() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<U>)
+      std::launder(reinterpret_cast<U*>(bytes_))->~U();
+  }
 
-  struct dummy {};
-  union {
-    dummy dummy_;
-    unexpected<E> unexpect_;
-    char uninit_;
-  };
-  bool has_val_;
+  // NOLINTNEXTLINE(*-avoid-c-arrays): Raw storage
+  alignas(U) unsigned char bytes_[sizeof(U)];
 };
 
 // Construction and assignment.
@@ -567,6 +766,20 @@ struct expected_operations_base : expected_storage_base<T, E> {
     this->has_val_ = false;
   }
 
+  template <class F, class... Args>
+  constexpr void construct(in_place_invoke_t, F&& f, Args&&... args) {
+    auto invoke = [&]() -> decltype(auto) {
+      return std::forward<F>(f)(std::forward<Args>(args)...);
+    };
+    if constexpr (invoke_construction<void, T, F&&, Args&&...>::elided) {
+      std::construct_at(std::addressof(this->val_),
+                        invoke_elider<decltype(invoke)>{invoke});
+    } else {
+      std::construct_at(std::addressof(this->val_), invoke());
+    }
+    this->has_val_ = true;
+  }
+
   constexpr void destroy(std::in_place_t) {
     if constexpr (!std::is_trivially_destructible_v<T>)
       this->val_.~T();
@@ -595,46 +808,84 @@ struct expected_operations_base : expected_storage_base<T, E> {
     }
   }
 
-  void assign(const expected_operations_base& other) {
+  // Replaces the active member with the other alternative, taken from other.
+  // Used during constant evaluation, where an exception ends the evaluation so
+  // there is nothing to roll back, and memcpy cannot be used to relocate.
+  template <class That>
+  constexpr void reconstruct_from(That&& other) {
+    if (this->has_val_)
+      destroy(std::in_place);
+    else
+      destroy(unexpect);
+    construct_from(std::forward<That>(other));
+  }
+
+  constexpr void assign(const expected_operations_base& other) {
+    if (std::is_constant_evaluated() && this->has_val_ != other.has_val_) {
+      reconstruct_from(other);
+      return;
+    }
     if (this->has_val_) {
       if (other.has_val_) {
         this->val_ = other.val_; // This can throw.
       } else {
-        if constexpr (std::is_nothrow_copy_constructible_v<E>) {
+        if constexpr (!exceptions_enabled ||
+                      std::is_nothrow_copy_constructible_v<E>) {
           destroy(std::in_place);
           construct(unexpect, other.unexpect_);
         } else if constexpr (std::is_nothrow_move_constructible_v<E>) {
           unexpected<E> tmp = other.unexpect_; // This can throw.
           destroy(std::in_place);
           construct(unexpect, std::move(tmp));
+        } else if constexpr (is_trivially_relocatable_v<T>) {
+          relocation_buffer<T> tmp;
+          tmp.relocate_from(this->val_);
+          BC_STD_EXPECTED_TRY {
+            construct(unexpect, other.unexpect_); // This can throw.
+          } BC_STD_EXPECTED_CATCH_ALL {
+            tmp.relocate_to(this->val_);
+            BC_STD_EXPECTED_RETHROW;
+          }
+          tmp.destroy();
         } else { // std::is_nothrow_move_constructible_v<T>
           T tmp = std::move(this->val_);
           destroy(std::in_place);
-          try {
+          BC_STD_EXPECTED_TRY {
             construct(unexpect, other.unexpect_); // This can throw.
-          } catch (...) {
+          } BC_STD_EXPECTED_CATCH_ALL {
             construct(std::in_place, std::move(tmp));
-            throw;
+            BC_STD_EXPECTED_RETHROW;
           }
         }
       }
     } else {
       if (other.has_val_) {
-        if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+        if constexpr (!exceptions_enabled ||
+                      std::is_nothrow_copy_constructible_v<T>) {
           destroy(unexpect);
           construct(std::in_place, other.val_);
         } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
           T tmp = other.val_; // This can throw.
           destroy(unexpect);
           construct(std::in_place, std::move(tmp));
+        } else if constexpr (is_trivially_relocatable_v<E>) {
+          relocation_buffer<unexpected<E>> tmp;
+          tmp.relocate_from(this->unexpect_);
+          BC_STD_EXPECTED_TRY {
+            construct(std::in_place, other.val_); // This can throw.
+          } BC_STD_EXPECTED_CATCH_ALL {
+            tmp.relocate_to(this->unexpect_);
+            BC_STD_EXPECTED_RETHROW;
+          }
+          tmp.destroy();
         } else { // std::is_nothrow_move_constructible_v<E>
           unexpected<E> tmp = std::move(this->unexpect_);
           destroy(unexpect);
-          try {
+          BC_STD_EXPECTED_TRY {
             construct(std::in_place, other.val_); // This can throw.
-          } catch (...) {
+          } BC_STD_EXPECTED_CATCH_ALL {
             construct(unexpect, std::move(tmp));
-            throw;
+            BC_STD_EXPECTED_RETHROW;
           }
         }
       } else {
@@ -643,38 +894,64 @@ struct expected_operations_base : expected_storage_base<T, E> {
     }
   }
 
-  void assign(expected_operations_base&& other) {
+  constexpr void assign(expected_operations_base&& other) {
+    if (std::is_constant_evaluated() && this->has_val_ != other.has_val_) {
+      reconstruct_from(std::move(other));
+      return;
+    }
     if (this->has_val_) {
       if (other.has_val_) {
         this->val_ = std::move(other).val_; // This can throw.
       } else {
-        if constexpr (std::is_nothrow_move_constructible_v<E>) {
+        if constexpr (!exceptions_enabled ||
+                      std::is_nothrow_move_constructible_v<E>) {
           destroy(std::in_place);
           construct(unexpect, std::move(other).unexpect_);
+        } else if constexpr (is_trivially_relocatable_v<T>) {
+          relocation_buffer<T> tmp;
+          tmp.relocate_from(this->val_);
+          BC_STD_EXPECTED_TRY {
+            construct(unexpect, std::move(other).unexpect_); // This can throw.
+          } BC_STD_EXPECTED_CATCH_ALL {
+            tmp.relocate_to(this->val_);
+            BC_STD_EXPECTED_RETHROW;
+          }
+          tmp.destroy();
         } else { // std::is_nothrow_move_constructible_v<T>
           T tmp = std::move(this->val_);
           destroy(std::in_place);
-          try {
+          BC_STD_EXPECTED_TRY {
             construct(unexpect, std::move(other).unexpect_); // This can throw.
-          } catch (...) {
+          } BC_STD_EXPECTED_CATCH_ALL {
             construct(std::in_place, std::move(tmp));
-            throw;
+            BC_STD_EXPECTED_RETHROW;
           }
         }
       }
     } else {
       if (other.has_val_) {
-        if constexpr (std::is_nothrow_move_constructible_v<T>) {
+        if constexpr (!exceptions_enabled ||
+                      std::is_nothrow_move_constructible_v<T>) {
           destroy(unexpect);
           construct(std::in_place, std::move(other).val_);
+        } else if constexpr (is_trivially_relocatable_v<E>) {
+          relocation_buffer<unexpected<E>> tmp;
+          tmp.relocate_from(this->unexpect_);
+          BC_STD_EXPECTED_TRY {
+            construct(std::in_place, std::move(other).val_); // This can throw.
+          } BC_STD_EXPECTED_CATCH_ALL {
+            tmp.relocate_to(this->unexpect_);
+            BC_STD_EXPECTED_RETHROW;
+          }
+          tmp.destroy();
         } else { // std::is_nothrow_move_constructible_v<E>
           unexpected<E> tmp = std::move(this->unexpect_);
           destroy(unexpect);
-          try {
+          BC_STD_EXPECTED_TRY {
             construct(std::in_place, std::move(other).val_); // This can throw.
-          } catch (...) {
+          } BC_STD_EXPECTED_CATCH_ALL {
             construct(unexpect, std::move(tmp));
-            throw;
+            BC_STD_EXPECTED_RETHROW;
           }
         }
       } else {
@@ -683,34 +960,46 @@ struct expected_operations_base : expected_storage_base<T, E> {
     }
   }
 
-  void swap_impl(expected_operations_base& other) {
+  constexpr void swap_impl(expected_operations_base& other) {
     if (this->has_val_) {
       if (other.has_val_) {
         using std::swap;
         swap(this->val_, other.val_);
       } else {
+        if constexpr (is_trivially_relocatable_v<T> &&
+                      is_trivially_relocatable_v<E>) {
+          if (!std::is_constant_evaluated()) {
+            relocation_buffer<unexpected<E>> tmp;
+            tmp.relocate_from(other.unexpect_);
+            relocate(other.val_, this->val_);
+            tmp.relocate_to(this->unexpect_);
+            this->has_val_ = false;
+            other.has_val_ = true;
+            return;
+          }
+        }
         if constexpr (std::is_nothrow_move_constructible_v<E>) {
           unexpected<E> tmp = std::move(other.unexpect_);
           other.destroy(unexpect);
-          try {
+          BC_STD_EXPECTED_TRY {
             other.construct(std::in_place,
                             std::move(*this).val_); // This can throw.
             destroy(std::in_place);
             construct(unexpect, std::move(tmp));
-          } catch (...) {
+          } BC_STD_EXPECTED_CATCH_ALL {
             other.construct(unexpect, std::move(tmp));
-            throw;
+            BC_STD_EXPECTED_RETHROW;
           }
         } else { // std::is_nothrow_move_constructible_v<T>
           T tmp = std::move(this->val_);
           destroy(std::in_place);
-          try {
+          BC_STD_EXPECTED_TRY {
             construct(unexpect, std::move(other).unexpect_); // This can throw.
             other.destroy(unexpect);
             other.construct(std::in_place, std::move(tmp));
-          } catch (...) {
+          } BC_STD_EXPECTED_CATCH_ALL {
             construct(std::in_place, std::move(tmp));
-            throw;
+            BC_STD_EXPECTED_RETHROW;
           }
         }
       }
@@ -768,7 +1057,7 @@ struct expected_operations_base<void, E> : expected_storage_base<void, E> {
     }
   }
 
-  void assign(const expected_operations_base& other) {
+  constexpr void assign(const expected_operations_base& other) {
     if (this->has_val_) {
       if (other.has_val_) {
         // Nothing to do.
@@ -786,7 +1075,7 @@ struct expected_operations_base<void, E> : expected_storage_base<void, E> {
     }
   }
 
-  void assign(expected_operations_base&& other) {
+  constexpr void assign(expected_operations_base&& other) {
     if (this->has_val_) {
       if (other.has_val_) {
         // Nothing to do.
@@ -804,11 +1093,19 @@ struct expected_operations_base<void, E> : expected_storage_base<void, E> {
     }
   }
 
-  void swap_impl(expected_operations_base& other) {
+  constexpr void swap_impl(expected_operations_base& other) {
     if (this->has_val_) {
       if (other.has_val_) {
         // Nothing to do.
       } else {
+        if constexpr (is_trivially_relocatable_v<E>) {
+          if (!std::is_constant_evaluated()) {
+            relocate(this->unexpect_, other.unexpect_);
+            this->has_val_ = false;
+            other.has_val_ = true;
+            return;
+          }
+        }
         destroy(std::in_place);
         construct(unexpect, std::move(other).unexpect_); // This can throw.
         other.destroy(unexpect);
@@ -825,285 +1122,64 @@ struct expected_operations_base<void, E> : expected_storage_base<void, E> {
   }
 };
 
-// Copy constructor. Trivially copy constructible if both T and E are.
-// clang-format off
-template <class T, class E,
-          bool = is_trivially_copy_constructible_or_void_v<T> &&
-                 std::is_trivially_copy_constructible_v<E>>
-struct expected_copy_base;
-// clang-format on
-
-// Both T and E are trivially copy constructible.
-template <class T, class E>
-struct expected_copy_base<T, E, true> : expected_operations_base<T, E> {
-  using base_type = expected_operations_base<T, E>;
-
-  using base_type::base_type;
-};
-
-// Either T, E or both are not trivially copy constructible.
-template <class T, class E>
-struct expected_copy_base<T, E, false> : expected_operations_base<T, E> {
-  using base_type = expected_operations_base<T, E>;
-
-  using base_type::base_type;
-
-  expected_copy_base() = default;
-
-  expected_copy_base(const expected_copy_base& other) : base_type(uninit) {
-    this->construct_from(other);
-  }
-
-  expected_copy_base(expected_copy_base&&) = default;
-  ~expected_copy_base() = default;
-  expected_copy_base& operator=(const expected_copy_base&) = default;
-  expected_copy_base& operator=(expected_copy_base&&) = default;
-};
-
-// Move constructor. Trivially move constructible if both T and E are.
-// clang-format off
-template <class T, class E,
-          bool = is_trivially_move_constructible_or_void_v<T> &&
-                 std::is_trivially_move_constructible_v<E>>
-struct expected_move_base;
-// clang-format on
-
-// Both T and E are trivially move constructible.
-template <class T, class E>
-struct expected_move_base<T, E, true> : expected_copy_base<T, E> {
-  using base_type = expected_copy_base<T, E>;
-
-  using base_type::base_type;
-};
-
-// Either T, E or both are not trivially move constructible.
-template <class T, class E>
-struct expected_move_base<T, E, false> : expected_copy_base<T, E> {
-  using base_type = expected_copy_base<T, E>;
-
-  using base_type::base_type;
-
-  expected_move_base() = default;
-  expected_move_base(const expected_move_base&) = default;
-
-  expected_move_base(expected_move_base&& other) noexcept(
-      // clang-format off
-      is_nothrow_move_constructible_or_void_v<T> &&
-      std::is_nothrow_move_constructible_v<E>)
-      // clang-format on
-      : base_type(uninit) {
-    this->construct_from(std::move(other));
-  }
-
-  ~expected_move_base() = default;
-  expected_move_base& operator=(const expected_move_base&) = default;
-  expected_move_base& operator=(expected_move_base&&) = default;
-};
-
-// Copy assignment operator. Trivially copy assignable if both T and E are.
-// clang-format off
-template <class T, class E,
-          bool = is_trivially_copy_assignable_or_void_v<T> &&
-                 is_trivially_copy_constructible_or_void_v<T> &&
-                 is_trivially_destructible_or_void_v<T> &&
-                 std::is_trivially_copy_assignable_v<E> &&
-                 std::is_trivially_copy_constructible_v<E> &&
-                 std::is_trivially_destructible_v<E>>
-struct expected_copy_assign_base;
-// clang-format on
-
-// Both T and E are trivially copy assignable.
+// Conditions for the special members of expected.
 template <class T, class E>
-struct expected_copy_assign_base<T, E, true> : expected_move_base<T, E> {
-  using base_type = expected_move_base<T, E>;
-
-  using base_type::base_type;
-};
-
-// Either T, E or both are not trivially copy assignable.
-template <class T, class E>
-struct expected_copy_assign_base<T, E, false> : expected_move_base<T, E> {
-  using base_type = expected_move_base<T, E>;
-
-  using base_type::base_type;
-
-  expected_copy_assign_base() = default;
-  expected_copy_assign_base(const expected_copy_assign_base&) = default;
-  expected_copy_assign_base(expected_copy_assign_base&&) = default;
-  ~expected_copy_assign_base() = default;
-
-  expected_copy_assign_base& operator=(const expected_copy_assign_base& other) {
-    this->assign(other);
-    return *this;
-  }
-
-  expected_copy_assign_base& operator=(expected_copy_assign_base&&) = default;
-};
-
-// Move assignment operator. Trivially move assignable if both T and E are.
-// clang-format off
-template <class T, class E,
-          bool = is_trivially_move_assignable_or_void_v<T> &&
-                 is_trivially_move_constructible_or_void_v<T> &&
-                 is_trivially_destructible_or_void_v<T> &&
-                 std::is_trivially_move_assignable_v<E> &&
-                 std::is_trivially_move_constructible_v<E> &&
-                 std::is_trivially_destructible_v<E>>
-struct expected_move_assign_base;
-// clang-format on
-
-// Both T and E are trivially move assignable.
-template <class T, class E>
-struct expected_move_assign_base<T, E, true> : expected_copy_assign_base<T, E> {
-  using base_type = expected_copy_assign_base<T, E>;
-
-  using base_type::base_type;
-};
-
-// Either T, E or both are not trivially move assignable.
-template <class T, class E>
-struct expected_move_assign_base<T, E, false>
-    : expected_copy_assign_base<T, E> {
-  using base_type = expected_copy_assign_base<T, E>;
-
-  using base_type::base_type;
-
-  expected_move_assign_base() = default;
-  expected_move_assign_base(const expected_move_assign_base&) = default;
-  expected_move_assign_base(expected_move_assign_base&&) = default;
-  ~expected_move_assign_base() = default;
-  expected_move_assign_base&
-  operator=(const expected_move_assign_base&) = default;
-
-  expected_move_assign_base&
-  operator=(expected_move_assign_base&& other) noexcept(
-      // clang-format off
-      is_nothrow_move_assignable_or_void_v<T> &&
-      is_nothrow_move_constructible_or_void_v<T> &&
-      std::is_nothrow_move_assignable_v<E> &&
-      std::is_nothrow_move_constructible_v<E>) {
-    // clang-format on
-    this->assign(std::move(other));
-    return *this;
-  }
-};
-
-struct construct_t {
-  explicit construct_t() = default;
-};
-
-inline constexpr construct_t construct{};
-
-// Default constructible if T is.
-template <bool>
-struct default_constructible_if {
-  default_constructible_if() = default;
-
-  constexpr explicit default_constructible_if(construct_t) {}
-};
-
-template <>
-struct default_constructible_if<false> {
-  default_constructible_if() = delete;
-
-  constexpr explicit default_constructible_if(construct_t) {}
-};
+inline constexpr bool expected_copy_constructible =
+    is_copy_constructible_or_void_v<T> && std::is_copy_constructible_v<E>;
 
 template <class T, class E>
-using expected_default_constructible_if =
-    default_constructible_if<is_default_constructible_or_void_v<T>>;
-
-// Copy constructible if both T and E are.
-template <bool>
-struct copy_constructible_if {};
-
-template <>
-struct copy_constructible_if<false> {
-  copy_constructible_if() = default;
-  copy_constructible_if(const copy_constructible_if&) = delete;
-  copy_constructible_if(copy_constructible_if&&) = default;
-  ~copy_constructible_if() = default;
-  copy_constructible_if& operator=(const copy_constructible_if&) = default;
-  copy_constructible_if& operator=(copy_constructible_if&&) = default;
-};
+inline constexpr bool expected_trivially_copy_constructible =
+    is_trivially_copy_constructible_or_void_v<T> &&
+    std::is_trivially_copy_constructible_v<E>;
 
 template <class T, class E>
-using expected_copy_constructible_if =
-    copy_constructible_if<is_copy_constructible_or_void_v<T> &&
-                          std::is_copy_constructible_v<E>>;
-
-// Move constructible if both T and E are.
-template <bool>
-struct move_constructible_if {};
-
-template <>
-struct move_constructible_if<false> {
-  move_constructible_if() = default;
-  move_constructible_if(const move_constructible_if&) = default;
-  move_constructible_if(move_constructible_if&&) = delete;
-  ~move_constructible_if() = default;
-  move_constructible_if& operator=(const move_constructible_if&) = default;
-  move_constructible_if& operator=(move_constructible_if&&) = default;
-};
+inline constexpr bool expected_move_constructible =
+    is_move_constructible_or_void_v<T> && std::is_move_constructible_v<E>;
 
 template <class T, class E>
-using expected_move_constructible_if =
-    move_constructible_if<is_move_constructible_or_void_v<T> &&
-                          std::is_move_constructible_v<E>>;
-
-// Copy assignable if both T and E are.
-template <bool>
-struct copy_assignable_if {};
-
-template <>
-struct copy_assignable_if<false> {
-  copy_assignable_if() = default;
-  copy_assignable_if(const copy_assignable_if&) = default;
-  copy_assignable_if(copy_assignable_if&&) = default;
-  ~copy_assignable_if() = default;
-  copy_assignable_if& operator=(const copy_assignable_if&) = delete;
-  copy_assignable_if& operator=(copy_assignable_if&&) = default;
-};
+inline constexpr bool expected_trivially_move_constructible =
+    is_trivially_move_constructible_or_void_v<T> &&
+    std::is_trivially_move_constructible_v<E>;
 
 template <class T, class E>
-using expected_copy_assignable_if = copy_assignable_if<
+inline constexpr bool expected_copy_assignable =
     is_copy_constructible_or_void_v<T> && std::is_copy_constructible_v<E> &&
     is_copy_assignable_or_void_v<T> && std::is_copy_assignable_v<E> &&
     (is_nothrow_move_constructible_or_void_v<T> ||
-     std::is_nothrow_move_constructible_v<E>)>;
+     std::is_nothrow_move_constructible_v<E>);
 
-// Move assignable if both T and E are.
-template <bool>
-struct move_assignable_if {};
-
-template <>
-struct move_assignable_if<false> {
-  move_assignable_if() = default;
-  move_assignable_if(const move_assignable_if&) = default;
-  move_assignable_if(move_assignable_if&&) = default;
-  ~move_assignable_if() = default;
-  move_assignable_if& operator=(const move_assignable_if&) = default;
-  move_assignable_if& operator=(move_assignable_if&&) = delete;
-};
+template <class T, class E>
+inline constexpr bool expected_trivially_copy_assignable =
+    expected_copy_assignable<T, E> &&
+    is_trivially_copy_assignable_or_void_v<T> &&
+    is_trivially_copy_constructible_or_void_v<T> &&
+    is_trivially_destructible_or_void_v<T> &&
+    std::is_trivially_copy_assignable_v<E> &&
+    std::is_trivially_copy_constructible_v<E> &&
+    std::is_trivially_destructible_v<E>;
 
 template <class T, class E>
-using expected_move_assignable_if = move_assignable_if<
+inline constexpr bool expected_move_assignable =
     is_move_constructible_or_void_v<T> && std::is_move_constructible_v<E> &&
     is_move_assignable_or_void_v<T> && std::is_move_assignable_v<E> &&
     (is_nothrow_move_constructible_or_void_v<T> ||
-     std::is_nothrow_move_constructible_v<E>)>;
+     std::is_nothrow_move_constructible_v<E>);
+
+template <class T, class E>
+inline constexpr bool expected_trivially_move_assignable =
+    expected_move_assignable<T, E> &&
+    is_trivially_move_assignable_or_void_v<T> &&
+    is_trivially_move_constructible_or_void_v<T> &&
+    is_trivially_destructible_or_void_v<T> &&
+    std::is_trivially_move_assignable_v<E> &&
+    std::is_trivially_move_constructible_v<E> &&
+    std::is_trivially_destructible_v<E>;
 
 } // namespace detail
 
 template <class T, class E>
-class expected : private detail::expected_move_assign_base<T, E>,
-                 private detail::expected_default_constructible_if<T, E>,
-                 private detail::expected_copy_constructible_if<T, E>,
-                 private detail::expected_move_constructible_if<T, E>,
-                 private detail::expected_copy_assignable_if<T, E>,
-                 private detail::expected_move_assignable_if<T, E> {
-  using base_type = detail::expected_move_assign_base<T, E>;
-  using ctor_base = detail::expected_default_constructible_if<T, E>;
+class expected : private detail::expected_operations_base<T, E> {
+  using base_type = detail::expected_operations_base<T, E>;
 
 public:
   static_assert(!std::is_same_v<T, std::remove_cv_t<unexpected<E>>>);
@@ -1121,17 +1197,42 @@ public:
   template <class U>
   using rebind = expected<U, error_type>;
 
-  constexpr expected() = default;
+  constexpr expected()
+    requires detail::is_default_constructible_or_void_v<T>
+  = default;
+
+  // The copy and move constructors and assignment operators are trivial if
+  // those of both T and E are.
+  constexpr expected(const expected&)
+    requires detail::expected_trivially_copy_constructible<T, E>
+  = default;
+
+  constexpr expected(const expected& other)
+    requires(detail::expected_copy_constructible<T, E> &&
+             !detail::expected_trivially_copy_constructible<T, E>)
+      : base_type(detail::uninit) {
+    this->construct_from(static_cast<const base_type&>(other));
+  }
+
+  constexpr expected(expected&&)
+    requires detail::expected_trivially_move_constructible<T, E>
+  = default;
 
-  constexpr expected(const expected&) = default;
-  constexpr expected(expected&&) = default;
+  constexpr expected(expected&& other) noexcept(
+      detail::is_nothrow_move_constructible_or_void_v<T> &&
+      std::is_nothrow_move_constructible_v<E>)
+    requires(detail::expected_move_constructible<T, E> &&
+             !detail::expected_trivially_move_constructible<T, E>)
+      : base_type(detail::uninit) {
+    this->construct_from(static_cast<base_type&&>(other));
+  }
 
   template <class U, class G,
             detail::enable_expected_expected_void_constructor<
                 T, E, U, G, const G&>* = nullptr,
             std::enable_if_t<std::is_convertible_v<const G&, E>>* = nullptr>
   constexpr expected(const expected<U, G>& other)
-      : base_type(detail::uninit), ctor_base(detail::construct) {
+      : base_type(detail::uninit) {
     this->construct_from_ex(other);
   }
 
@@ -1140,7 +1241,7 @@ public:
                 T, E, U, G, const G&>* = nullptr,
             std::enable_if_t<!std::is_convertible_v<const G&, E>>* = nullptr>
   constexpr explicit expected(const expected<U, G>& other)
-      : base_type(detail::uninit), ctor_base(detail::construct) {
+      : base_type(detail::uninit) {
     this->construct_from_ex(other);
   }
 
@@ -1153,7 +1254,7 @@ public:
                              std::is_convertible_v<const G&, E>>* = nullptr>
   // clang-format on
   constexpr expected(const expected<U, G>& other)
-      : base_type(detail::uninit), ctor_base(detail::construct) {
+      : base_type(detail::uninit) {
     this->construct_from_ex(other);
   }
 
@@ -1164,7 +1265,7 @@ public:
                               !std::is_convertible_v<const U&, T>) ||
                              !std::is_convertible_v<const G&, E>>* = nullptr>
   constexpr explicit expected(const expected<U, G>& other)
-      : base_type(detail::uninit), ctor_base(detail::construct) {
+      : base_type(detail::uninit) {
     this->construct_from_ex(other);
   }
 
@@ -1173,7 +1274,7 @@ public:
                                                               G&&>* = nullptr,
             std::enable_if_t<std::is_convertible_v<G&&, E>>* = nullptr>
   constexpr expected(expected<U, G>&& other)
-      : base_type(detail::uninit), ctor_base(detail::construct) {
+      : base_type(detail::uninit) {
     this->construct_from_ex(std::move(other));
   }
 
@@ -1182,7 +1283,7 @@ public:
                                                               G&&>* = nullptr,
             std::enable_if_t<!std::is_convertible_v<G&&, E>>* = nullptr>
   constexpr explicit expected(expected<U, G>&& other)
-      : base_type(detail::uninit), ctor_base(detail::construct) {
+      : base_type(detail::uninit) {
     this->construct_from_ex(std::move(other));
   }
 
@@ -1195,7 +1296,7 @@ public:
                              std::is_convertible_v<G&&, E>>* = nullptr>
   // clang-format on
   constexpr expected(expected<U, G>&& other)
-      : base_type(detail::uninit), ctor_base(detail::construct) {
+      : base_type(detail::uninit) {
     this->construct_from_ex(std::move(other));
   }
 
@@ -1206,7 +1307,7 @@ public:
                               !std::is_convertible_v<U&&, T>) ||
                              !std::is_convertible_v<G&&, E>>* = nullptr>
   constexpr explicit expected(expected<U, G>&& other)
-      : base_type(detail::uninit), ctor_base(detail::construct) {
+      : base_type(detail::uninit) {
     this->construct_from_ex(std::move(other));
   }
 
@@ -1214,27 +1315,25 @@ public:
             detail::enable_expected_value_constructor<T, E, U>* = nullptr,
             std::enable_if_t<std::is_convertible_v<U&&, T>>* = nullptr>
   constexpr expected(U&& v)
-      : base_type(std::in_place, std::forward<U>(v)),
-        ctor_base(detail::construct) {}
+      : base_type(std::in_place, std::forward<U>(v)) {}
 
   template <class U = T,
             detail::enable_expected_value_constructor<T, E, U>* = nullptr,
             std::enable_if_t<!std::is_convertible_v<U&&, T>>* = nullptr>
   constexpr explicit expected(U&& v)
-      : base_type(std::in_place, std::forward<U>(v)),
-        ctor_base(detail::construct) {}
+      : base_type(std::in_place, std::forward<U>(v)) {}
 
   template <class G = E,
             std::enable_if_t<std::is_constructible_v<E, const G&>>* = nullptr,
             std::enable_if_t<std::is_convertible_v<const G&, E>>* = nullptr>
   constexpr expected(const unexpected<G>& e)
-      : base_type(unexpect, e.value()), ctor_base(detail::construct) {}
+      : base_type(unexpect, e.value()) {}
 
   template <class G = E,
             std::enable_if_t<std::is_constructible_v<E, const G&>>* = nullptr,
             std::enable_if_t<!std::is_convertible_v<const G&, E>>* = nullptr>
   constexpr explicit expected(const unexpected<G>& e)
-      : base_type(unexpect, e.value()), ctor_base(detail::construct) {}
+      : base_type(unexpect, e.value()) {}
 
   template <class G = E,
             std::enable_if_t<std::is_constructible_v<E, G&&>>* = nullptr,
@@ -1242,8 +1341,7 @@ public:
   // NOLINTNEXTLINE(*-rvalue-reference-param-not-moved): Moved via value
   constexpr expected(unexpected<G>&& e) noexcept(
       std::is_nothrow_constructible_v<E, G&&>)
-      : base_type(unexpect, std::move(e.value())),
-        ctor_base(detail::construct) {}
+      : base_type(unexpect, std::move(e.value())) {}
 
   template <class G = E,
             std::enable_if_t<std::is_constructible_v<E, G&&>>* = nullptr,
@@ -1251,8 +1349,7 @@ public:
   // NOLINTNEXTLINE(*-rvalue-reference-param-not-moved): Moved via value
   constexpr explicit expected(unexpected<G>&& e) noexcept(
       std::is_nothrow_constructible_v<E, G&&>)
-      : base_type(unexpect, std::move(e.value())),
-        ctor_base(detail::construct) {}
+      : base_type(unexpect, std::move(e.value())) {}
 
   template <
       class... Args,
@@ -1260,8 +1357,7 @@ public:
                        (!std::is_void_v<T> &&
                         std::is_constructible_v<T, Args&&...>)>* = nullptr>
   constexpr explicit expected(std::in_place_t, Args&&... args)
-      : base_type(std::in_place, std::forward<Args>(args)...),
-        ctor_base(detail::construct) {}
+      : base_type(std::in_place, std::forward<Args>(args)...) {}
 
   template <
       class U, class... Args,
@@ -1270,27 +1366,66 @@ public:
                                                Args&&...>>* = nullptr>
   constexpr explicit expected(std::in_place_t, std::initializer_list<U> il,
                               Args&&... args)
-      : base_type(std::in_place, il, std::forward<Args>(args)...),
-        ctor_base(detail::construct) {}
+      : base_type(std::in_place, il, std::forward<Args>(args)...) {}
 
   template <class... Args,
             std::enable_if_t<std::is_constructible_v<E, Args&&...>>* = nullptr>
   constexpr explicit expected(unexpect_t, Args&&... args)
-      : base_type(unexpect, std::forward<Args>(args)...),
-        ctor_base(detail::construct) {}
+      : base_type(unexpect, std::forward<Args>(args)...) {}
 
   template <class U, class... Args,
             std::enable_if_t<std::is_constructible_v<
                 E, std::initializer_list<U>&, Args&&...>>* = nullptr>
   constexpr explicit expected(unexpect_t, std::initializer_list<U> il,
                               Args&&... args)
-      : base_type(unexpect, il, std::forward<Args>(args)...),
-        ctor_base(detail::construct) {}
+      : base_type(unexpect, il, std::forward<Args>(args)...) {}
+
+  template <class F, class... Args, class T1 = T,
+            std::enable_if_t<!std::is_void_v<T1>>* = nullptr,
+            std::enable_if_t<detail::is_invoke_constructible_v<
+                T1, F&&, Args&&...>>* = nullptr>
+  constexpr explicit expected(in_place_invoke_t, F&& f, Args&&... args)
+      : base_type(in_place_invoke, std::forward<F>(f),
+                  std::forward<Args>(args)...) {}
+
+  template <class F, class... Args,
+            std::enable_if_t<detail::is_invoke_constructible_v<
+                E, F&&, Args&&...>>* = nullptr>
+  constexpr explicit expected(unexpect_invoke_t, F&& f, Args&&... args)
+      : base_type(unexpect_invoke, std::forward<F>(f),
+                  std::forward<Args>(args)...) {}
 
   ~expected() = default;
 
-  expected& operator=(const expected&) = default;
-  expected& operator=(expected&&) = default;
+  constexpr expected& operator=(const expected&)
+    requires detail::expected_trivially_copy_assignable<T, E>
+  = default;
+
+  constexpr expected& operator=(const expected& other)
+    requires(detail::expected_copy_assignable<T, E> &&
+             !detail::expected_trivially_copy_assignable<T, E>)
+  {
+    this->assign(other);
+    return *this;
+  }
+
+  constexpr expected& operator=(expected&&)
+    requires detail::expected_trivially_move_assignable<T, E>
+  = default;
+
+  constexpr expected& operator=(expected&& other) noexcept(
+      // clang-format off
+      detail::is_nothrow_move_assignable_or_void_v<T> &&
+      detail::is_nothrow_move_constructible_or_void_v<T> &&
+      std::is_nothrow_move_assignable_v<E> &&
+      std::is_nothrow_move_constructible_v<E>)
+    // clang-format on
+    requires(detail::expected_move_assignable<T, E> &&
+             !detail::expected_trivially_move_assignable<T, E>)
+  {
+    this->assign(std::move(other));
+    return *this;
+  }
 
   template <
       class U = T, class T1 = T,
@@ -1301,21 +1436,22 @@ public:
                               std::is_same<T, std::remove_cvref_t<U>>> &&
           std::is_constructible_v<T, U&&> && std::is_assignable_v<T1&, U&&> &&
           std::is_nothrow_move_constructible_v<E>>* = nullptr>
-  expected& operator=(U&& v) {
+  constexpr expected& operator=(U&& v) {
     if (this->has_val_) {
       this->val_ = std::forward<U>(v); // This can throw.
     } else {
-      if constexpr (std::is_nothrow_constructible_v<T, U&&>) {
+      if constexpr (!detail::exceptions_enabled ||
+                    std::is_nothrow_constructible_v<T, U&&>) {
         this->destroy(unexpect);
         this->construct(std::in_place, std::forward<U>(v));
       } else { // std::is_nothrow_move_constructible_v<E>
         unexpected<E> tmp = std::move(this->unexpect_);
         this->destroy(unexpect);
-        try {
+        BC_STD_EXPECTED_TRY {
           this->construct(std::in_place, std::forward<U>(v)); // This can throw.
-        } catch (...) {
+        } BC_STD_EXPECTED_CATCH_ALL {
           this->construct(unexpect, std::move(tmp));
-          throw;
+          BC_STD_EXPECTED_RETHROW;
         }
       }
     }
@@ -1325,7 +1461,7 @@ public:
   template <class G = E,
             std::enable_if_t<std::is_nothrow_constructible_v<E, const G&> &&
                              std::is_assignable_v<E&, const G&>>* = nullptr>
-  expected& operator=(const unexpected<G>& e) {
+  constexpr expected& operator=(const unexpected<G>& e) {
     if (this->has_val_) {
       this->destroy(std::in_place);
       this->construct(unexpect, e.value());
@@ -1338,7 +1474,7 @@ public:
   template <class G = E,
             std::enable_if_t<std::is_nothrow_constructible_v<E, G&&> &&
                              std::is_assignable_v<E&, G&&>>* = nullptr>
-  expected& operator=(unexpected<G>&& e) {
+  constexpr expected& operator=(unexpected<G>&& e) {
     if (this->has_val_) {
       this->destroy(std::in_place);
       this->construct(unexpect, std::move(e.value()));
@@ -1349,7 +1485,7 @@ public:
   }
 
   template <class T1 = T, std::enable_if_t<std::is_void_v<T1>>* = nullptr>
-  void emplace() {
+  constexpr void emplace() {
     if (!this->has_val_) {
       this->destroy(unexpect);
       this->construct(std::in_place);
@@ -1363,10 +1499,11 @@ public:
                        std::is_move_assignable_v<T> &&
                        (std::is_nothrow_move_constructible_v<T> ||
                         std::is_nothrow_move_constructible_v<E>)>* = nullptr>
-  T1& emplace(Args&&... args) {
+  constexpr T1& emplace(Args&&... args) {
     if (this->has_val_) {
       this->val_ = T(std::forward<Args>(args)...); // This can throw.
-    } else if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+    } else if constexpr (!detail::exceptions_enabled ||
+                         std::is_nothrow_constructible_v<T, Args&&...>) {
       this->destroy(unexpect);
       this->construct(std::in_place, std::forward<Args>(args)...);
     } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
@@ -1376,12 +1513,12 @@ public:
     } else { // std::is_nothrow_move_constructible_v<E>
       unexpected<E> tmp = std::move(this->unexpect_);
       this->destroy(unexpect);
-      try {
+      BC_STD_EXPECTED_TRY {
         this->construct(std::in_place,
                         std::forward<Args>(args)...); // This can throw.
-      } catch (...) {
+      } BC_STD_EXPECTED_CATCH_ALL {
         this->construct(unexpect, std::move(tmp));
-        throw;
+        BC_STD_EXPECTED_RETHROW;
       }
     }
     return this->val_;
@@ -1395,10 +1532,11 @@ public:
           std::is_move_assignable_v<T> &&
           (std::is_nothrow_move_constructible_v<T> ||
            std::is_nothrow_move_constructible_v<E>)>* = nullptr>
-  T1& emplace(std::initializer_list<U> il, Args&&... args) {
+  constexpr T1& emplace(std::initializer_list<U> il, Args&&... args) {
     if (this->has_val_) {
       this->val_ = T(il, std::forward<Args>(args)...); // This can throw.
-    } else if constexpr (std::is_nothrow_constructible_v<
+    } else if constexpr (!detail::exceptions_enabled ||
+                         std::is_nothrow_constructible_v<
                              T, std::initializer_list<U>&, Args&&...>) {
       this->destroy(unexpect);
       this->construct(std::in_place, il, std::forward<Args>(args)...);
@@ -1409,12 +1547,56 @@ public:
     } else { // std::is_nothrow_move_constructible_v<E>
       unexpected<E> tmp = std::move(this->unexpect_);
       this->destroy(unexpect);
-      try {
+      BC_STD_EXPECTED_TRY {
         this->construct(std::in_place, il,
                         std::forward<Args>(args)...); // This can throw.
-      } catch (...) {
+      } BC_STD_EXPECTED_CATCH_ALL {
+        this->construct(unexpect, std::move(tmp));
+        BC_STD_EXPECTED_RETHROW;
+      }
+    }
+    return this->val_;
+  }
+
+  // Unlike emplace, T need not be move assignable if constructing it from
+  // the result cannot throw. The old value or error is then destroyed first
+  // and the result is constructed in its place.
+  template <
+      class F, class... Args, class T1 = T,
+      std::enable_if_t<!std::is_void_v<T1>>* = nullptr,
+      std::enable_if_t<
+          detail::is_invoke_constructible_v<T1, F&&, Args&&...> &&
+          (!detail::exceptions_enabled ||
+           detail::is_nothrow_invoke_constructible_v<T1, F&&, Args&&...> ||
+           (std::is_move_assignable_v<T1> &&
+            (std::is_nothrow_move_constructible_v<T1> ||
+             std::is_nothrow_move_constructible_v<E>)))>* = nullptr>
+  constexpr T1& emplace_invoke(F&& f, Args&&... args) {
+    if constexpr (!detail::exceptions_enabled ||
+                  detail::is_nothrow_invoke_constructible_v<T, F&&,
+                                                            Args&&...>) {
+      if (this->has_val_)
+        this->destroy(std::in_place);
+      else
+        this->destroy(unexpect);
+      this->construct(in_place_invoke, std::forward<F>(f),
+                      std::forward<Args>(args)...);
+    } else if (this->has_val_) {
+      this->val_ =
+          T(std::forward<F>(f)(std::forward<Args>(args)...)); // This can throw.
+    } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+      T tmp(std::forward<F>(f)(std::forward<Args>(args)...)); // This can throw.
+      this->destroy(unexpect);
+      this->construct(std::in_place, std::move(tmp));
+    } else { // std::is_nothrow_move_constructible_v<E>
+      unexpected<E> tmp = std::move(this->unexpect_);
+      this->destroy(unexpect);
+      BC_STD_EXPECTED_TRY {
+        this->construct(in_place_invoke, std::forward<F>(f),
+                        std::forward<Args>(args)...); // This can throw.
+      } BC_STD_EXPECTED_CATCH_ALL {
         this->construct(unexpect, std::move(tmp));
-        throw;
+        BC_STD_EXPECTED_RETHROW;
       }
     }
     return this->val_;
@@ -1422,31 +1604,37 @@ public:
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr const T* operator->() const {
+    detail::check_access(this->has_val_, "has_value()");
     return std::addressof(this->val_);
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr T* operator->() {
+    detail::check_access(this->has_val_, "has_value()");
     return std::addressof(this->val_);
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr const T1& operator*() const& {
+    detail::check_access(this->has_val_, "has_value()");
     return this->val_;
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr T1& operator*() & {
+    detail::check_access(this->has_val_, "has_value()");
     return this->val_;
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr const T1&& operator*() const&& {
+    detail::check_access(this->has_val_, "has_value()");
     return std::move(this->val_);
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr T1&& operator*() && {
+    detail::check_access(this->has_val_, "has_value()");
     return std::move(this->val_);
   }
 
@@ -1456,43 +1644,56 @@ public:
   template <class T1 = T, std::enable_if_t<std::is_void_v<T1>>* = nullptr>
   constexpr void value() const {
     if (!this->has_val_)
-      throw bad_expected_access(this->unexpect_.value());
+      detail::throw_bad_expected_access(this->unexpect_.value());
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr const T1& value() const& {
     if (!this->has_val_)
-      throw bad_expected_access(this->unexpect_.value());
+      detail::throw_bad_expected_access(this->unexpect_.value());
     return this->val_;
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr T1& value() & {
     if (!this->has_val_)
-      throw bad_expected_access(this->unexpect_.value());
+      detail::throw_bad_expected_access(this->unexpect_.value());
     return this->val_;
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr const T1&& value() const&& {
     if (!this->has_val_)
-      throw bad_expected_access(std::move(this->unexpect_.value()));
+      detail::throw_bad_expected_access(std::move(this->unexpect_.value()));
     return std::move(this->val_);
   }
 
   template <class T1 = T, std::enable_if_t<!std::is_void_v<T1>>* = nullptr>
   constexpr T1&& value() && {
     if (!this->has_val_)
-      throw bad_expected_access(std::move(this->unexpect_.value()));
+      detail::throw_bad_expected_access(std::move(this->unexpect_.value()));
     return std::move(this->val_);
   }
 
-  constexpr const E& error() const& { return this->unexpect_.value(); }
-  constexpr E& error() & { return this->unexpect_.value(); }
+  constexpr const E& error() const& {
+    detail::check_access(!this->has_val_, "!has_value()");
+    return this->unexpect_.value();
+  }
+
+  constexpr E& error() & {
+    detail::check_access(!this->has_val_, "!has_value()");
+    return this->unexpect_.value();
+  }
+
   constexpr const E&& error() const&& {
+    detail::check_access(!this->has_val_, "!has_value()");
+    return std::move(this->unexpect_.value());
+  }
+
+  constexpr E&& error() && {
+    detail::check_access(!this->has_val_, "!has_value()");
     return std::move(this->unexpect_.value());
   }
-  constexpr E&& error() && { return std::move(this->unexpect_.value()); }
 
   template <class U, std::enable_if_t<std::is_copy_constructible_v<T> &&
                                       std::is_convertible_v<U&&, T>>* = nullptr>
@@ -1507,6 +1708,42 @@ public:
                           : static_cast<T>(std::forward<U>(v));
   }
 
+  // Like value_or, but the fallback is only computed, by calling f, if there
+  // is no value.
+  template <class F, class T1 = T,
+            std::enable_if_t<std::is_copy_constructible_v<T1> &&
+                             std::is_convertible_v<detail::call_result_t<F&&>,
+                                                   T1>>* = nullptr>
+  constexpr T value_or_else(F&& f) const& {
+    return this->has_val_ ? this->val_
+                          : static_cast<T>(std::forward<F>(f)());
+  }
+
+  template <class F, class T1 = T,
+            std::enable_if_t<std::is_move_constructible_v<T1> &&
+                             std::is_convertible_v<detail::call_result_t<F&&>,
+                                                   T1>>* = nullptr>
+  constexpr T value_or_else(F&& f) && {
+    return this->has_val_ ? std::move(this->val_)
+                          : static_cast<T>(std::forward<F>(f)());
+  }
+
+  template <class G = E,
+            std::enable_if_t<std::is_copy_constructible_v<E> &&
+                             std::is_convertible_v<G&&, E>>* = nullptr>
+  constexpr E error_or(G&& e) const& {
+    return this->has_val_ ? static_cast<E>(std::forward<G>(e))
+                          : this->unexpect_.value();
+  }
+
+  template <class G = E,
+            std::enable_if_t<std::is_move_constructible_v<E> &&
+                             std::is_convertible_v<G&&, E>>* = nullptr>
+  constexpr E error_or(G&& e) && {
+    return this->has_val_ ? static_cast<E>(std::forward<G>(e))
+                          : std::move(this->unexpect_.value());
+  }
+
   template <class T1 = T, class E1 = E,
             std::enable_if_t<
                 detail::is_move_constructible_or_void_v<T1> &&
@@ -1514,7 +1751,7 @@ public:
                 detail::is_swappable_or_void_v<T1> && std::is_swappable_v<E1> &&
                 (detail::is_nothrow_move_constructible_or_void_v<T1> ||
                  std::is_nothrow_move_constructible_v<E1>)>* = nullptr>
-  void swap(expected& other) noexcept(
+  constexpr void swap(expected& other) noexcept(
       // clang-format off
       detail::is_nothrow_move_constructible_or_void_v<T> &&
       std::is_nothrow_move_constructible_v<E> &&
@@ -1616,12 +1853,31 @@ template <class T, class E,
               detail::is_swappable_or_void_v<T> && std::is_swappable_v<E> &&
               (detail::is_nothrow_move_constructible_or_void_v<T> ||
                std::is_nothrow_move_constructible_v<E>)>* = nullptr>
-void swap(expected<T, E>& x, expected<T, E>& y) noexcept(noexcept(x.swap(y))) {
+constexpr void swap(expected<T, E>& x,
+                    expected<T, E>& y) noexcept(noexcept(x.swap(y))) {
   x.swap(y);
 }
 
 // NOLINTEND(*-pro-type-union-access): Tagged union
 
+#ifdef BC_STD_EXPECTED_EXTERN_TEMPLATES
+
+namespace detail {
+
+extern template struct expected_operations_base<void, std::error_code>;
+extern template struct expected_operations_base<int, std::error_code>;
+extern template struct expected_operations_base<std::string, std::string>;
+extern template struct expected_operations_base<std::size_t, std::errc>;
+
+} // namespace detail
+
+extern template class expected<void, std::error_code>;
+extern template class expected<int, std::error_code>;
+extern template class expected<std::string, std::string>;
+extern template class expected<std::size_t, std::errc>;
+
+#endif
+
 } // namespace bc
 
 #endif
@@ -0,0 +1,346 @@
+#ifndef INCLUDE_BC_EXPECTED_CACHE_H
+#define INCLUDE_BC_EXPECTED_CACHE_H
+
+#include "bc/expected.h"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace bc {
+
+// How an entry is chosen for eviction when a cache is full.
+enum class cache_eviction {
+  // The oldest entry.
+  fifo,
+  // The oldest entry not read since it was inserted or last passed over. An
+  // approximation of least recently used in which a read only sets a flag,
+  // under a shared lock, rather than reordering a list.
+  second_chance,
+};
+
+struct expected_cache_options {
+  using duration = std::chrono::nanoseconds;
+
+  static constexpr duration forever = duration::max();
+
+  // How long values and errors are kept. Zero does not cache them.
+  duration value_ttl = forever;
+  duration error_ttl = std::chrono::seconds(1);
+  // How many values and errors are kept, across all shards.
+  std::size_t max_values = 4096;
+  std::size_t max_errors = 1024;
+  cache_eviction value_eviction = cache_eviction::second_chance;
+  cache_eviction error_eviction = cache_eviction::fifo;
+  // Rounded up to a power of two.
+  std::size_t shards = 16;
+};
+
+// A concurrent map from K to expected<T, E>, to memoize lookups whose failures
+// are cached as well (negative caching), usually for a shorter time:
+//
+//   bc::expected_cache<std::string, Address, Lookup_error> cache(
+//       {.error_ttl = std::chrono::seconds(5)});
+//   auto address = cache.get_or_compute(host, [&] { return resolve(host); });
+//
+// Values and errors have their own time to live, capacity and eviction policy.
+// The keys are spread over shards, each with a shared mutex: hits take a shared
+// lock on one shard, and only inserts take it exclusively. Concurrent misses on
+// the same key in get_or_compute are computed once (single flight); the other
+// callers wait for that result.
+//
+// Results are returned by copy, since an entry may be evicted as soon as the
+// lock is released; a T that is expensive to copy can be held by shared_ptr.
+// Clock needs a now() member and a time_point; it can be replaced in tests.
+template <class K, class T, class E, class Hash = std::hash<K>,
+          class KeyEqual = std::equal_to<K>,
+          class Clock = std::chrono::steady_clock>
+class expected_cache {
+public:
+  using key_type = K;
+  using value_type = expected<T, E>;
+  using time_point = typename Clock::time_point;
+
+  explicit expected_cache(expected_cache_options options = {},
+                          Clock clock = Clock())
+      : options_(options), clock_(std::move(clock)),
+        shard_bits_(std::countr_zero(std::bit_ceil(
+            options.shards == 0 ? std::size_t{1} : options.shards))),
+        shards_(std::make_unique<shard[]>(std::size_t{1} << shard_bits_)),
+        max_values_(per_shard(options.max_values)),
+        max_errors_(per_shard(options.max_errors)) {}
+
+  expected_cache(const expected_cache&) = delete;
+  expected_cache& operator=(const expected_cache&) = delete;
+
+  ~expected_cache() = default;
+
+  // The result cached for key, unless there is none or it has expired.
+  std::optional<value_type> find(const K& key) const {
+    const shard& s = shard_for(key);
+    std::shared_lock lock(s.mutex);
+    if (const entry* e = find_locked(s, key, clock_.now()))
+      return e->result;
+    return std::nullopt;
+  }
+
+  // Caches result for key, replacing the entry there may be.
+  void insert(const K& key, value_type result) {
+    shard& s = shard_for(key);
+    std::unique_lock lock(s.mutex);
+    store_locked(s, key, std::move(result), clock_.now());
+  }
+
+  // The result cached for key, or else the result of compute(), which is
+  // cached. While compute runs, other calls for the same key wait for its
+  // result rather than computing it again. If compute throws, the exception
+  // propagates to its caller, and one of the waiting calls computes instead.
+  template <class F>
+  value_type get_or_compute(const K& key, F&& compute) {
+    shard& s = shard_for(key);
+    for (;;) {
+      std::shared_ptr<flight> f;
+      {
+        std::shared_lock lock(s.mutex);
+        if (const entry* e = find_locked(s, key, clock_.now()))
+          return e->result;
+        if (auto it = s.flights.find(key); it != s.flights.end())
+          f = it->second;
+      }
+      if (f == nullptr) {
+        auto fresh = std::make_shared<flight>();
+        std::unique_lock lock(s.mutex);
+        if (const entry* e = find_locked(s, key, clock_.now()))
+          return e->result;
+        auto [it, first] = s.flights.try_emplace(key, fresh);
+        if (first) {
+          lock.unlock();
+          return lead(s, key, fresh, std::forward<F>(compute));
+        }
+        f = it->second;
+      }
+      f->done.wait(false, std::memory_order_acquire);
+      if (f->result.has_value())
+        return *f->result;
+      // The computation threw; try again.
+    }
+  }
+
+  // Removes the entry for key. Returns whether there was one.
+  bool erase(const K& key) {
+    shard& s = shard_for(key);
+    std::unique_lock lock(s.mutex);
+    auto it = s.index.find(key);
+    if (it == s.index.end())
+      return false;
+    remove_locked(s, it);
+    return true;
+  }
+
+  void clear() {
+    for (std::size_t i = 0; i < shard_count(); ++i) {
+      shard& s = shards_[i];
+      std::unique_lock lock(s.mutex);
+      s.index.clear();
+      s.values.clear();
+      s.errors.clear();
+    }
+  }
+
+  // The number of entries, counting expired ones not removed yet.
+  std::size_t size() const {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < shard_count(); ++i) {
+      const shard& s = shards_[i];
+      std::shared_lock lock(s.mutex);
+      n += s.index.size();
+    }
+    return n;
+  }
+
+private:
+  static constexpr std::size_t cache_line = 64;
+
+  struct entry {
+    K key;
+    value_type result;
+    time_point expires;
+    // Set by reads, for second_chance.
+    mutable std::atomic<bool> referenced{false};
+  };
+
+  using entry_list = std::list<entry>;
+
+  // A computation in progress, shared with the calls that wait for it.
+  struct flight {
+    std::optional<value_type> result;
+    std::atomic<bool> done{false};
+  };
+
+  using index_map =
+      std::unordered_map<K, typename entry_list::iterator, Hash, KeyEqual>;
+
+  struct alignas(cache_line) shard {
+    mutable std::shared_mutex mutex;
+    index_map index;
+    // In insertion order, apart from the entries given a second chance.
+    entry_list values;
+    entry_list errors;
+    std::unordered_map<K, std::shared_ptr<flight>, Hash, KeyEqual> flights;
+  };
+
+  // Ends a flight whose computation threw, so that its waiters try again.
+  struct abandon_guard {
+    abandon_guard(shard* s, const K* key, flight* f) noexcept
+        : s(s), key(key), f(f) {}
+    abandon_guard(const abandon_guard&) = delete;
+    abandon_guard& operator=(const abandon_guard&) = delete;
+
+    ~abandon_guard() {
+      if (f == nullptr)
+        return;
+      {
+        std::unique_lock lock(s->mutex);
+        s->flights.erase(*key);
+      }
+      f->done.store(true, std::memory_order_release);
+      f->done.notify_all();
+    }
+
+    shard* s;
+    const K* key;
+    flight* f;
+  };
+
+  std::size_t shard_count() const noexcept {
+    return std::size_t{1} << shard_bits_;
+  }
+
+  std::size_t per_shard(std::size_t max) const noexcept {
+    return max / shard_count() + (max % shard_count() != 0 ? 1 : 0);
+  }
+
+  // The high bits of the hash multiplied by 2^64 / phi (Fibonacci hashing), so
+  // that the shard does not depend only on the bits the maps use.
+  std::size_t shard_index(const K& key) const {
+    if (shard_bits_ == 0)
+      return 0;
+    const auto h = static_cast<std::uint64_t>(hash_(key));
+    return static_cast<std::size_t>((h * 0x9e3779b97f4a7c15U) >>
+                                    (64 - shard_bits_));
+  }
+
+  shard& shard_for(const K& key) { return shards_[shard_index(key)]; }
+
+  const shard& shard_for(const K& key) const {
+    return shards_[shard_index(key)];
+  }
+
+  static time_point expiry(time_point now,
+                           expected_cache_options::duration ttl) {
+    if (ttl >= time_point::max() - now)
+      return time_point::max();
+    return now + std::chrono::duration_cast<typename Clock::duration>(ttl);
+  }
+
+  static const entry* find_locked(const shard& s, const K& key,
+                                  time_point now) {
+    auto it = s.index.find(key);
+    if (it == s.index.end())
+      return nullptr;
+    const entry& e = *it->second;
+    if (!(now < e.expires))
+      return nullptr;
+    // Only written when it changes, to keep the line shared between readers.
+    if (!e.referenced.load(std::memory_order_relaxed))
+      e.referenced.store(true, std::memory_order_relaxed);
+    return &e;
+  }
+
+  static void remove_locked(shard& s, typename index_map::iterator it) {
+    auto e = it->second;
+    (e->result.has_value() ? s.values : s.errors).erase(e);
+    s.index.erase(it);
+  }
+
+  // Removes entries from the front of list until it holds at most keep, or
+  // only entries that have not expired if it already does.
+  static void evict_locked(shard& s, entry_list& list, std::size_t keep,
+                           cache_eviction policy, time_point now) {
+    while (!list.empty()) {
+      entry& e = list.front();
+      if (list.size() <= keep && now < e.expires)
+        return;
+      if (now < e.expires && policy == cache_eviction::second_chance &&
+          e.referenced.load(std::memory_order_relaxed)) {
+        e.referenced.store(false, std::memory_order_relaxed);
+        list.splice(list.end(), list, list.begin());
+        continue;
+      }
+      s.index.erase(e.key);
+      list.pop_front();
+    }
+  }
+
+  void store_locked(shard& s, const K& key, value_type result,
+                    time_point now) {
+    if (auto it = s.index.find(key); it != s.index.end())
+      remove_locked(s, it);
+    const bool is_value = result.has_value();
+    const auto ttl = is_value ? options_.value_ttl : options_.error_ttl;
+    const std::size_t max = is_value ? max_values_ : max_errors_;
+    if (ttl <= expected_cache_options::duration::zero() || max == 0)
+      return;
+    entry_list& list = is_value ? s.values : s.errors;
+    evict_locked(
+        s, list, max - 1,
+        is_value ? options_.value_eviction : options_.error_eviction, now);
+    list.emplace_back(key, std::move(result), expiry(now, ttl));
+    s.index.emplace(key, std::prev(list.end()));
+  }
+
+  // Copies the result once for the cache, and once more for the waiters if
+  // there are any. They take their reference to f under the lock, and cannot
+  // find the flight once it is erased, so the count of references is exact
+  // then.
+  template <class F>
+  value_type lead(shard& s, const K& key, const std::shared_ptr<flight>& f,
+                  F&& compute) {
+    abandon_guard guard(&s, &key, f.get());
+    value_type result = std::invoke(std::forward<F>(compute));
+    {
+      std::unique_lock lock(s.mutex);
+      s.flights.erase(key);
+      if (f.use_count() > 1)
+        f->result.emplace(result);
+      store_locked(s, key, result, clock_.now());
+    }
+    guard.f = nullptr;
+    f->done.store(true, std::memory_order_release);
+    f->done.notify_all();
+    return result;
+  }
+
+  expected_cache_options options_;
+  Clock clock_;
+  [[no_unique_address]] Hash hash_;
+  int shard_bits_;
+  std::unique_ptr<shard[]> shards_;
+  std::size_t max_values_;
+  std::size_t max_errors_;
+};
+
+} // namespace bc
+
+#endif
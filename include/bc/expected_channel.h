@@ -0,0 +1,231 @@
+#ifndef INCLUDE_BC_EXPECTED_CHANNEL_H
+#define INCLUDE_BC_EXPECTED_CHANNEL_H
+
+#include "bc/expected.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace bc {
+
+namespace detail {
+
+inline constexpr std::size_t channel_cache_line = 64;
+
+// Spins with a pause instruction, then yields to other threads.
+class channel_backoff {
+public:
+  void operator()() noexcept {
+    if (spins_ < max_spins) {
+      ++spins_;
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  static constexpr int max_spins = 64;
+
+  int spins_ = 0;
+};
+
+// A slot holds a T only: the sequence number says whether it is full, and an
+// error can only be the last element of a channel, so it is kept once in the
+// channel rather than once per slot.
+template <class T, bool Padded>
+struct alignas(Padded ? std::max(channel_cache_line, alignof(T))
+                      : std::max(alignof(std::atomic<std::size_t>),
+                                 alignof(T))) channel_slot {
+  T* ptr() noexcept {
+    // NOLINTNEXTLINE(*-reinterpret-cast): Raw storage
+    return std::launder(reinterpret_cast<T*>(storage));
+  }
+
+  std::atomic<std::size_t> sequence;
+  // NOLINTNEXTLINE(*-avoid-c-arrays): Raw storage
+  alignas(T) unsigned char storage[sizeof(T)];
+};
+
+} // namespace detail
+
+// A bounded multi-producer multi-consumer queue of expected<T, E> values in a
+// ring buffer (Vyukov's algorithm: each slot has a sequence number, and
+// producers and consumers claim positions with a compare and swap). Values are
+// sent one at a time; an error is sent with close(), which ends the stream.
+// Receivers get the values sent before it, then the error, which every later
+// receive returns as well.
+//
+// With Padded, each slot takes at least a cache line, so that a producer and a
+// consumer working on neighbouring slots do not share one.
+template <class T, class E, bool Padded = true>
+class expected_channel {
+  static_assert(!std::is_void_v<T>);
+  static_assert(std::is_nothrow_move_constructible_v<T>);
+
+  using slot = detail::channel_slot<T, Padded>;
+
+public:
+  using value_type = expected<T, E>;
+
+  // The capacity is rounded up to a power of two.
+  explicit expected_channel(std::size_t capacity)
+      : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1),
+        slots_(std::make_unique<slot[]>(mask_ + 1)) {
+    for (std::size_t i = 0; i <= mask_; ++i)
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  expected_channel(const expected_channel&) = delete;
+  expected_channel& operator=(const expected_channel&) = delete;
+
+  ~expected_channel() {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t tail = tail_.load(std::memory_order_relaxed) & ~closed_bit;
+    for (; head != tail; ++head)
+      std::destroy_at(slots_[head & mask_].ptr());
+  }
+
+  std::size_t capacity() const noexcept { return mask_ + 1; }
+
+  bool closed() const noexcept {
+    return (tail_.load(std::memory_order_acquire) & closed_bit) != 0;
+  }
+
+  // Sends a value unless the channel is full or closed. If T can be
+  // constructed from the arguments without throwing, it is constructed in the
+  // slot, and the arguments are only used if the value is sent. Otherwise it
+  // is constructed first and moved into the slot.
+  template <class... Args>
+  bool try_send(Args&&... args) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+      return try_emplace(std::forward<Args>(args)...);
+    else
+      return try_emplace(T(std::forward<Args>(args)...));
+  }
+
+  // Sends a value, waiting while the channel is full. Returns false if the
+  // channel is closed.
+  template <class... Args>
+  bool send(Args&&... args) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+      detail::channel_backoff backoff;
+      while (!try_emplace(std::forward<Args>(args)...)) {
+        if (closed())
+          return false;
+        backoff();
+      }
+      return true;
+    } else {
+      return send(T(std::forward<Args>(args)...));
+    }
+  }
+
+  // Closes the channel with an error. Returns false, and does nothing, if it
+  // was already closed.
+  template <class... Args>
+  bool close(Args&&... args) {
+    if (closing_.exchange(true, std::memory_order_relaxed))
+      return false;
+    error_.emplace(std::forward<Args>(args)...);
+    tail_.fetch_or(closed_bit, std::memory_order_release);
+    return true;
+  }
+
+  // The next value, the error if the channel is closed and all values have
+  // been received, or nothing if no value is available yet.
+  std::optional<value_type> try_receive() {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      slot& s = slots_[pos & mask_];
+      std::size_t sequence = s.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed))
+          return take(s, pos);
+      } else if (diff < 0) {
+        // Either empty, or a producer has claimed the slot but not yet
+        // written it. Once closed, no position is claimed after the tail.
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        if (tail == (pos | closed_bit))
+          return value_type(unexpect, *error_);
+        return std::nullopt;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // The next value, or the error once the channel is closed and drained,
+  // waiting while the channel is empty.
+  value_type receive() {
+    detail::channel_backoff backoff;
+    for (;;) {
+      if (std::optional<value_type> v = try_receive())
+        return std::move(*v);
+      backoff();
+    }
+  }
+
+private:
+  // Set in the tail by close(), so that no position is claimed afterwards.
+  static constexpr std::size_t closed_bit = std::size_t{1}
+                                            << (sizeof(std::size_t) * 8 - 1);
+
+  template <class... Args>
+  bool try_emplace(Args&&... args) noexcept {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      if ((pos & closed_bit) != 0)
+        return false;
+      slot& s = slots_[pos & mask_];
+      std::size_t sequence = s.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    slot& s = slots_[pos & mask_];
+    // NOLINTNEXTLINE(*-reinterpret-cast): Raw storage
+    std::construct_at(reinterpret_cast<T*>(s.storage),
+                      std::forward<Args>(args)...);
+    s.sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  value_type take(slot& s, std::size_t pos) {
+    value_type v(std::in_place, std::move(*s.ptr()));
+    std::destroy_at(s.ptr());
+    s.sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return v;
+  }
+
+  alignas(detail::channel_cache_line) std::atomic<std::size_t> tail_{0};
+  alignas(detail::channel_cache_line) std::atomic<std::size_t> head_{0};
+  alignas(detail::channel_cache_line) const std::size_t mask_;
+  std::unique_ptr<slot[]> slots_;
+  std::atomic<bool> closing_{false};
+  std::optional<E> error_;
+};
+
+} // namespace bc
+
+#endif
@@ -0,0 +1,355 @@
+#ifndef INCLUDE_BC_EXPECTED_FUTURE_H
+#define INCLUDE_BC_EXPECTED_FUTURE_H
+
+#include "bc/expected.h"
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bc {
+
+enum class promise_errc {
+  // The promise was destroyed without a result.
+  broken_promise = 1,
+};
+
+// The error that the future of a promise destroyed without a result gets. By
+// default E(promise_errc::broken_promise); specialize it, with a static error()
+// that returns an E, for an E that cannot be constructed from promise_errc.
+template <class E>
+struct broken_promise_error {
+  static E error()
+    requires std::is_constructible_v<E, promise_errc>
+  {
+    return E(promise_errc::broken_promise);
+  }
+};
+
+namespace detail {
+
+template <class E>
+concept has_broken_promise_error = requires {
+  { broken_promise_error<E>::error() } -> std::convertible_to<E>;
+};
+
+// Makes a promise that its owner always sets, so that E needs no
+// broken_promise_error.
+struct unbreakable_promise_t {
+  explicit unbreakable_promise_t() = default;
+};
+
+// Bits of future_state::word_.
+inline constexpr std::uint32_t future_ready = 1;
+inline constexpr std::uint32_t future_waiting = 2;
+inline constexpr std::uint32_t future_promise_ref = 4;
+inline constexpr std::uint32_t future_future_ref = 8;
+
+// Shared state of an expected_promise and its expected_future. States are
+// never freed: when both sides are done with one, its result is destroyed and
+// it goes back to future_state_pool.
+template <class T, class E>
+struct future_state {
+  template <class... Args>
+  void set(Args&&... args) {
+    // NOLINTNEXTLINE(*-reinterpret-cast): Raw storage
+    std::construct_at(reinterpret_cast<expected<T, E>*>(storage_),
+                      std::forward<Args>(args)...);
+    // Sets ready and drops the reference of the promise in one operation.
+    std::uint32_t old = word_.fetch_xor(future_ready | future_promise_ref,
+                                        std::memory_order_acq_rel);
+    if ((old & future_waiting) != 0)
+      word_.notify_one();
+    if ((old & future_future_ref) == 0)
+      recycle();
+  }
+
+  bool ready() const noexcept {
+    return (word_.load(std::memory_order_acquire) & future_ready) != 0;
+  }
+
+  void wait() noexcept {
+    std::uint32_t word = word_.load(std::memory_order_acquire);
+    while ((word & future_ready) == 0) {
+      if ((word & future_waiting) == 0) {
+        word = word_.fetch_or(future_waiting, std::memory_order_acquire) |
+               future_waiting;
+        continue;
+      }
+      word_.wait(word, std::memory_order_acquire);
+      word = word_.load(std::memory_order_acquire);
+    }
+  }
+
+  expected<T, E>& result() noexcept { return *result_ptr(); }
+
+  void release(std::uint32_t ref) noexcept {
+    std::uint32_t old = word_.fetch_and(~ref, std::memory_order_acq_rel);
+    if ((old & (future_promise_ref | future_future_ref)) == ref)
+      recycle();
+  }
+
+  void recycle() noexcept;
+
+  expected<T, E>* result_ptr() noexcept {
+    // NOLINTNEXTLINE(*-reinterpret-cast): Raw storage
+    return std::launder(reinterpret_cast<expected<T, E>*>(storage_));
+  }
+
+  std::atomic<std::uint32_t> word_{0};
+  future_state* next_ = nullptr;
+  // NOLINTNEXTLINE(*-avoid-c-arrays): Raw storage
+  alignas(expected<T, E>) unsigned char storage_[sizeof(expected<T, E>)];
+};
+
+// Pool of future_state<T, E>. Each thread keeps up to cache_size states; the
+// rest are shared under a mutex. A state is only allocated when both are
+// empty, so a program that keeps a bounded number of promises in flight stops
+// allocating once the pool has grown to that number.
+template <class T, class E>
+class future_state_pool {
+public:
+  using state = future_state<T, E>;
+
+  static state* acquire() {
+    thread_cache& cache = local_cache();
+    if (cache.head == nullptr)
+      shared().take(cache);
+    state* s = cache.head;
+    if (s == nullptr)
+      return new state();
+    cache.head = s->next_;
+    --cache.size;
+    return s;
+  }
+
+  static void release(state* s) noexcept {
+    thread_cache& cache = local_cache();
+    s->next_ = cache.head;
+    cache.head = s;
+    if (++cache.size > cache_size)
+      shared().give(cache, cache_size / 2);
+  }
+
+private:
+  static constexpr std::size_t cache_size = 64;
+
+  struct thread_cache {
+    thread_cache() = default;
+    thread_cache(const thread_cache&) = delete;
+    thread_cache& operator=(const thread_cache&) = delete;
+    ~thread_cache() { shared().give(*this, size); }
+
+    state* head = nullptr;
+    std::size_t size = 0;
+  };
+
+  struct shared_list {
+    shared_list() = default;
+    shared_list(const shared_list&) = delete;
+    shared_list& operator=(const shared_list&) = delete;
+    ~shared_list() {
+      while (head != nullptr)
+        delete std::exchange(head, head->next_);
+    }
+
+    // Moves up to half of cache_size states to cache.
+    void take(thread_cache& cache) {
+      std::lock_guard lock(mutex);
+      while (head != nullptr && cache.size < cache_size / 2) {
+        state* s = std::exchange(head, head->next_);
+        s->next_ = cache.head;
+        cache.head = s;
+        ++cache.size;
+      }
+    }
+
+    // Moves n states from cache.
+    void give(thread_cache& cache, std::size_t n) noexcept {
+      std::lock_guard lock(mutex);
+      for (; n != 0 && cache.head != nullptr; --n) {
+        state* s = std::exchange(cache.head, cache.head->next_);
+        --cache.size;
+        s->next_ = head;
+        head = s;
+      }
+    }
+
+    std::mutex mutex;
+    state* head = nullptr;
+  };
+
+  static shared_list& shared() {
+    static shared_list list;
+    return list;
+  }
+
+  static thread_cache& local_cache() {
+    thread_local thread_cache cache;
+    return cache;
+  }
+};
+
+template <class T, class E>
+void future_state<T, E>::recycle() noexcept {
+  if ((word_.load(std::memory_order_relaxed) & future_ready) != 0)
+    std::destroy_at(result_ptr());
+  word_.store(0, std::memory_order_relaxed);
+  future_state_pool<T, E>::release(this);
+}
+
+} // namespace detail
+
+template <class T, class E>
+class expected_future;
+
+// The producing side of a single result. The shared state comes from a pool,
+// and handing over the result takes one atomic operation, plus a futex wake if
+// the future is waiting.
+//
+// If the promise is destroyed without a result after get_future() was called,
+// the future gets the error broken_promise_error<E>::error(). An E without one
+// is rejected at compile time.
+template <class T, class E>
+class expected_promise {
+public:
+  expected_promise() : expected_promise(detail::unbreakable_promise_t()) {
+    static_assert(detail::has_broken_promise_error<E>,
+                  "E must be constructible from bc::promise_errc, or "
+                  "bc::broken_promise_error<E> must be specialized");
+  }
+
+  explicit expected_promise(detail::unbreakable_promise_t)
+      : state_(detail::future_state_pool<T, E>::acquire()) {
+    state_->word_.store(detail::future_promise_ref, std::memory_order_relaxed);
+  }
+
+  expected_promise(expected_promise&& other) noexcept
+      : state_(std::exchange(other.state_, nullptr)),
+        future_retrieved_(other.future_retrieved_) {}
+
+  expected_promise& operator=(expected_promise&& other) noexcept {
+    expected_promise(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  expected_promise(const expected_promise&) = delete;
+  expected_promise& operator=(const expected_promise&) = delete;
+
+  ~expected_promise() {
+    if (state_ == nullptr)
+      return;
+    if (!future_retrieved_) {
+      state_->release(detail::future_promise_ref);
+      return;
+    }
+    // Only an unbreakable promise can lack a broken_promise_error, and its
+    // owner sets it.
+    if constexpr (detail::has_broken_promise_error<E>)
+      set_error(broken_promise_error<E>::error());
+    else
+      std::terminate();
+  }
+
+  void swap(expected_promise& other) noexcept {
+    std::swap(state_, other.state_);
+    std::swap(future_retrieved_, other.future_retrieved_);
+  }
+
+  // May be called once.
+  expected_future<T, E> get_future() {
+    // The future only holds a reference once it exists, so that a result set
+    // without one is destroyed at once.
+    state_->word_.fetch_or(detail::future_future_ref,
+                           std::memory_order_relaxed);
+    future_retrieved_ = true;
+    return expected_future<T, E>(state_);
+  }
+
+  // Each sets the result; one of them may be called once. If constructing the
+  // result throws, the promise has no result yet.
+
+  template <class... Args>
+  void set_value(Args&&... args) {
+    state_->set(std::in_place, std::forward<Args>(args)...);
+    state_ = nullptr;
+  }
+
+  template <class... Args>
+  void set_error(Args&&... args) {
+    state_->set(unexpect, std::forward<Args>(args)...);
+    state_ = nullptr;
+  }
+
+  template <class U = expected<T, E>>
+  void set_result(U&& result) {
+    state_->set(std::forward<U>(result));
+    state_ = nullptr;
+  }
+
+private:
+  detail::future_state<T, E>* state_;
+  bool future_retrieved_ = false;
+};
+
+// The consuming side of a single result.
+template <class T, class E>
+class expected_future {
+public:
+  expected_future() = default;
+
+  expected_future(expected_future&& other) noexcept
+      : state_(std::exchange(other.state_, nullptr)) {}
+
+  expected_future& operator=(expected_future&& other) noexcept {
+    expected_future(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  expected_future(const expected_future&) = delete;
+  expected_future& operator=(const expected_future&) = delete;
+
+  ~expected_future() {
+    if (state_ != nullptr)
+      state_->release(detail::future_future_ref);
+  }
+
+  void swap(expected_future& other) noexcept {
+    std::swap(state_, other.state_);
+  }
+
+  // Whether the future refers to a shared state; false after get().
+  bool valid() const noexcept { return state_ != nullptr; }
+
+  bool is_ready() const noexcept { return state_->ready(); }
+
+  void wait() const noexcept { state_->wait(); }
+
+  // Waits for the result and moves it out. The future is no longer valid
+  // afterwards.
+  expected<T, E> get() {
+    state_->wait();
+    expected<T, E> result = std::move(state_->result());
+    std::exchange(state_, nullptr)->release(detail::future_future_ref);
+    return result;
+  }
+
+private:
+  friend class expected_promise<T, E>;
+
+  explicit expected_future(detail::future_state<T, E>* state) noexcept
+      : state_(state) {}
+
+  detail::future_state<T, E>* state_ = nullptr;
+};
+
+} // namespace bc
+
+#endif
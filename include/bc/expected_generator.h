@@ -0,0 +1,167 @@
+#ifndef INCLUDE_BC_EXPECTED_GENERATOR_H
+#define INCLUDE_BC_EXPECTED_GENERATOR_H
+
+#include "bc/expected.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <utility>
+
+namespace bc {
+
+// A coroutine that yields a sequence of expected<T, E>, as an input range:
+//
+//   bc::expected_generator<Record, Parse_error> parse(std::istream& in) {
+//     for (std::string line; std::getline(in, line);)
+//       co_yield parse_record(line);
+//   }
+//
+//   for (auto& r : parse(in).stop_on_error())
+//     ...
+//
+// Iterators refer to the yielded expected in the coroutine frame, so an
+// expected yielded as an rvalue or a non-const lvalue is never copied, and its
+// value may be moved out. A const lvalue is copied into the promise.
+template <class T, class E>
+class [[nodiscard]] expected_generator
+    : public std::ranges::view_interface<expected_generator<T, E>> {
+public:
+  using value_type = expected<T, E>;
+
+  class promise_type {
+  public:
+    expected_generator get_return_object() noexcept {
+      return expected_generator(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value(value_type& v) noexcept {
+      current_ = std::addressof(v);
+      return {};
+    }
+
+    std::suspend_always yield_value(value_type&& v) noexcept {
+      current_ = std::addressof(v);
+      return {};
+    }
+
+    std::suspend_always yield_value(const value_type& v) {
+      current_ = std::addressof(copy_.emplace(v));
+      return {};
+    }
+
+    void return_void() noexcept {}
+
+    // Rethrown from begin() or operator++.
+    void unhandled_exception() {
+      std::rethrow_exception(std::current_exception());
+    }
+
+    template <class U>
+    std::suspend_never await_transform(U&&) = delete;
+
+  private:
+    friend expected_generator;
+
+    value_type* current_ = nullptr;
+    std::optional<value_type> copy_;
+    bool stop_on_error_ = false;
+    // Set once an error was yielded with stop_on_error_.
+    bool stopped_ = false;
+  };
+
+  class iterator {
+  public:
+    using value_type = expected<T, E>;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+
+    value_type& operator*() const noexcept {
+      return *handle_.promise().current_;
+    }
+
+    value_type* operator->() const noexcept {
+      return handle_.promise().current_;
+    }
+
+    iterator& operator++() {
+      promise_type& p = handle_.promise();
+      if (p.stop_on_error_ && !p.current_->has_value())
+        p.stopped_ = true;
+      else
+        handle_.resume();
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& it,
+                           std::default_sentinel_t /*unused*/) noexcept {
+      return it.done();
+    }
+
+  private:
+    friend expected_generator;
+
+    bool done() const noexcept {
+      return handle_.done() || handle_.promise().stopped_;
+    }
+
+    explicit iterator(std::coroutine_handle<promise_type> h) noexcept
+        : handle_(h) {}
+
+    std::coroutine_handle<promise_type> handle_;
+  };
+
+  expected_generator() = default;
+
+  expected_generator(expected_generator&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+
+  expected_generator& operator=(expected_generator&& other) noexcept {
+    if (this != &other) {
+      if (handle_)
+        handle_.destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  ~expected_generator() {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  // Ends the iteration after the first error, which is still seen.
+  expected_generator stop_on_error() && noexcept {
+    handle_.promise().stop_on_error_ = true;
+    return std::move(*this);
+  }
+
+  // May be called once; starts the coroutine.
+  iterator begin() {
+    handle_.resume();
+    return iterator(handle_);
+  }
+
+  std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+  explicit expected_generator(std::coroutine_handle<promise_type> h) noexcept
+      : handle_(h) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+} // namespace bc
+
+#endif
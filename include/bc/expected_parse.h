@@ -0,0 +1,313 @@
+#ifndef INCLUDE_BC_EXPECTED_PARSE_H
+#define INCLUDE_BC_EXPECTED_PARSE_H
+
+#include "bc/expected.h"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+// Parsing primitives that report errors through bc::expected. They are
+// constexpr, so tables of configuration strings can be validated and converted
+// at compile time:
+//
+//   constexpr auto port = bc::parse_int<std::uint16_t>("8080");
+//   static_assert(port.has_value());
+
+namespace bc {
+
+enum class parse_errc {
+  invalid_argument = 1, // No number, or a name that is not known.
+  result_out_of_range,  // The number is not representable by the type.
+  trailing_characters,  // The input continues after the number.
+  too_many_fields,      // The input has more fields than the bound.
+};
+
+struct parse_error {
+  parse_errc code;
+  // Offset in the input of the character where the error was detected.
+  std::size_t position;
+
+  friend constexpr bool operator==(const parse_error&,
+                                   const parse_error&) = default;
+};
+
+namespace detail {
+
+constexpr bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// The value of c as a digit in base, or -1 if it is not one.
+constexpr int digit_value(char c, int base) {
+  int value = -1;
+  if (c >= '0' && c <= '9')
+    value = c - '0';
+  else if (c >= 'a' && c <= 'z')
+    value = c - 'a' + 10;
+  else if (c >= 'A' && c <= 'Z')
+    value = c - 'A' + 10;
+  return value < base ? value : -1;
+}
+
+constexpr char to_lower(char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Whether s starts with prefix, ignoring case. prefix is lower case.
+constexpr bool starts_with_icase(std::string_view s, std::string_view prefix) {
+  if (s.size() < prefix.size())
+    return false;
+  for (std::size_t i = 0; i < prefix.size(); ++i) {
+    if (to_lower(s[i]) != prefix[i])
+      return false;
+  }
+  return true;
+}
+
+// Computes m * 10^exp10. Exact if m and 10^|exp10| are exactly representable
+// by F (Clinger's fast path), otherwise rounded more than once through long
+// double.
+template <class F>
+constexpr F scale_by_power_of_10(std::uint64_t m, int exp10) {
+  constexpr int max_exact_exp10 =
+      std::numeric_limits<F>::digits >= 53 ? 22 : 10;
+  constexpr std::uint64_t max_exact_mantissa =
+      std::numeric_limits<F>::digits >= 64
+          ? std::numeric_limits<std::uint64_t>::max()
+          : std::uint64_t{1} << std::numeric_limits<F>::digits;
+  if (m <= max_exact_mantissa && exp10 >= -max_exact_exp10 &&
+      exp10 <= max_exact_exp10) {
+    F power = 1;
+    for (int i = 0; i < (exp10 < 0 ? -exp10 : exp10); ++i)
+      power *= 10;
+    return exp10 < 0 ? static_cast<F>(m) / power : static_cast<F>(m) * power;
+  }
+
+  long double value = static_cast<long double>(m);
+  long double power = 10;
+  for (int n = exp10 < 0 ? -exp10 : exp10; n != 0; n /= 2) {
+    if (n % 2 != 0)
+      value = exp10 < 0 ? value / power : value * power;
+    power *= power;
+  }
+  return static_cast<F>(value);
+}
+
+template <class F>
+constexpr expected<F, parse_error> parse_float_constexpr(std::string_view s) {
+  std::size_t i = 0;
+  bool negative = false;
+  if (i < s.size() && s[i] == '-') {
+    negative = true;
+    ++i;
+  }
+  const auto sign = [&](F value) { return negative ? -value : value; };
+
+  if (starts_with_icase(s.substr(i), "inf")) {
+    i += starts_with_icase(s.substr(i), "infinity") ? 8 : 3;
+    if (i != s.size())
+      return unexpected(parse_error{parse_errc::trailing_characters, i});
+    return sign(std::numeric_limits<F>::infinity());
+  }
+  if (starts_with_icase(s.substr(i), "nan")) {
+    i += 3;
+    if (i != s.size())
+      return unexpected(parse_error{parse_errc::trailing_characters, i});
+    return sign(std::numeric_limits<F>::quiet_NaN());
+  }
+
+  // Up to 19 significant digits fit in std::uint64_t; the rest only move the
+  // decimal point.
+  constexpr int max_digits = 19;
+  std::uint64_t mantissa = 0;
+  int digits = 0;
+  int exp10 = 0;
+  bool any_digit = false;
+  for (; i < s.size() && is_digit(s[i]); ++i) {
+    any_digit = true;
+    if (digits < max_digits) {
+      mantissa = mantissa * 10 + static_cast<std::uint64_t>(s[i] - '0');
+      if (mantissa != 0)
+        ++digits;
+    } else {
+      ++exp10;
+    }
+  }
+  if (i < s.size() && s[i] == '.') {
+    ++i;
+    for (; i < s.size() && is_digit(s[i]); ++i) {
+      any_digit = true;
+      if (digits < max_digits) {
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(s[i] - '0');
+        if (mantissa != 0)
+          ++digits;
+        --exp10;
+      }
+    }
+  }
+  if (!any_digit)
+    return unexpected(parse_error{parse_errc::invalid_argument, 0});
+
+  if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+    std::size_t j = i + 1;
+    bool negative_exp = false;
+    if (j < s.size() && (s[j] == '+' || s[j] == '-')) {
+      negative_exp = s[j] == '-';
+      ++j;
+    }
+    if (j < s.size() && is_digit(s[j])) {
+      // Large enough to overflow or underflow any floating point type.
+      constexpr int max_exp10 = 100000;
+      int exp = 0;
+      for (; j < s.size() && is_digit(s[j]); ++j) {
+        if (exp < max_exp10)
+          exp = exp * 10 + (s[j] - '0');
+      }
+      exp10 += negative_exp ? -exp : exp;
+      i = j;
+    }
+  }
+  if (i != s.size())
+    return unexpected(parse_error{parse_errc::trailing_characters, i});
+
+  if (mantissa == 0)
+    return sign(F(0));
+  const F value = scale_by_power_of_10<F>(mantissa, exp10);
+  if (value == F(0) || value > std::numeric_limits<F>::max())
+    return unexpected(parse_error{parse_errc::result_out_of_range, 0});
+  return sign(value);
+}
+
+} // namespace detail
+
+// Parses an integer in base 2 to 36, as std::from_chars does: an optional
+// minus sign for signed types, then digits, with no leading whitespace or plus
+// sign. The whole input must be consumed.
+template <class Int>
+constexpr expected<Int, parse_error> parse_int(std::string_view s,
+                                               int base = 10) {
+  static_assert(std::is_integral_v<Int> && !std::is_same_v<Int, bool>);
+  using Uint = std::make_unsigned_t<Int>;
+
+  std::size_t i = 0;
+  bool negative = false;
+  if constexpr (std::is_signed_v<Int>) {
+    if (i < s.size() && s[i] == '-') {
+      negative = true;
+      ++i;
+    }
+  }
+  // The magnitude of the most negative value is one more than the maximum.
+  const Uint limit = static_cast<Uint>(std::numeric_limits<Int>::max()) +
+                     static_cast<Uint>(negative ? 1 : 0);
+
+  const std::size_t first_digit = i;
+  Uint magnitude = 0;
+  bool overflow = false;
+  for (int d = 0; i < s.size() && (d = detail::digit_value(s[i], base)) >= 0;
+       ++i) {
+    const auto digit = static_cast<Uint>(d);
+    if (magnitude > (limit - digit) / static_cast<Uint>(base))
+      overflow = true;
+    else
+      magnitude = magnitude * static_cast<Uint>(base) + digit;
+  }
+  if (i == first_digit)
+    return unexpected(parse_error{parse_errc::invalid_argument, 0});
+  if (overflow)
+    return unexpected(parse_error{parse_errc::result_out_of_range, 0});
+  if (i != s.size())
+    return unexpected(parse_error{parse_errc::trailing_characters, i});
+
+  if (negative)
+    return static_cast<Int>(Uint(0) - magnitude);
+  return static_cast<Int>(magnitude);
+}
+
+// Parses a floating point number in the general format of std::from_chars:
+// an optional minus sign, digits with an optional decimal point, and an
+// optional exponent; or inf, infinity or nan in any case. The whole input must
+// be consumed. At run time this is std::from_chars. During constant evaluation
+// the result is exact for up to 15 significant digits (7 for float) and
+// decimal exponents up to 22 (10 for float); beyond that it can differ in the
+// last bit.
+template <class Float>
+constexpr expected<Float, parse_error> parse_float(std::string_view s) {
+  static_assert(std::is_floating_point_v<Float>);
+  if (std::is_constant_evaluated())
+    return detail::parse_float_constexpr<Float>(s);
+
+  Float value{};
+  const char* last = s.data() + s.size();
+  auto [ptr, ec] =
+      std::from_chars(s.data(), last, value, std::chars_format::general);
+  if (ec == std::errc::invalid_argument)
+    return unexpected(parse_error{parse_errc::invalid_argument, 0});
+  if (ec == std::errc::result_out_of_range)
+    return unexpected(parse_error{parse_errc::result_out_of_range, 0});
+  if (ptr != last) {
+    return unexpected(parse_error{parse_errc::trailing_characters,
+                                  static_cast<std::size_t>(ptr - s.data())});
+  }
+  return value;
+}
+
+template <class Enum>
+struct enum_name {
+  std::string_view name;
+  Enum value;
+};
+
+// Looks up the enumerator with the given name. Names are compared exactly.
+template <class Enum>
+constexpr expected<Enum, parse_error>
+parse_enum(std::string_view s, std::span<const enum_name<Enum>> names) {
+  for (const enum_name<Enum>& n : names) {
+    if (n.name == s)
+      return n.value;
+  }
+  return unexpected(parse_error{parse_errc::invalid_argument, 0});
+}
+
+// Up to N fields of a string, which refer to the string.
+template <std::size_t N>
+struct split_result {
+  constexpr std::string_view operator[](std::size_t i) const {
+    return fields[i];
+  }
+
+  constexpr const std::string_view* begin() const { return fields.data(); }
+  constexpr const std::string_view* end() const { return fields.data() + size; }
+
+  std::array<std::string_view, N> fields{};
+  std::size_t size = 0;
+};
+
+// Splits s at each delimiter into at most N fields. An empty string has one
+// empty field. More than N fields is an error, reported at the delimiter that
+// starts field N + 1.
+template <std::size_t N>
+constexpr expected<split_result<N>, parse_error>
+split_bounded(std::string_view s, char delimiter) {
+  static_assert(N > 0);
+  split_result<N> result;
+  std::size_t first = 0;
+  for (;;) {
+    const std::size_t last = s.find(delimiter, first);
+    if (result.size == N)
+      return unexpected(parse_error{parse_errc::too_many_fields, first - 1});
+    result.fields[result.size++] = s.substr(first, last - first);
+    if (last == std::string_view::npos)
+      return result;
+    first = last + 1;
+  }
+}
+
+} // namespace bc
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef INCLUDE_BC_EXPECTED_TASK_H
+#define INCLUDE_BC_EXPECTED_TASK_H
+
+#include "bc/expected.h"
+#include "bc/expected_future.h"
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// A lazy coroutine type whose result is an expected<T, E>:
+//
+//   bc::expected_task<Config, Error> load(std::string_view path) {
+//     std::string text = co_await read_file(path);  // Returns on error.
+//     bc::expected<Config, Error> config = co_await parse(text);
+//     co_return config;
+//   }
+//
+// Inside an expected_task, co_await of an expected_task yields its expected,
+// and co_await of an expected yields its value, or completes the task with
+// its error without running the rest of the body. No exception is involved;
+// an exception that escapes a task calls std::terminate.
+
+namespace bc {
+
+template <class T, class E>
+class expected_task;
+
+namespace detail {
+
+// Recycles coroutine frames through per-thread free lists, one per size class
+// of 64 bytes up to 1 KiB. Larger frames use ::operator new.
+class frame_allocator {
+public:
+  static void* allocate(std::size_t size) {
+    const std::size_t c = size_class(size);
+    if (c < classes) {
+      cache& local = local_cache();
+      if (block* b = local.heads[c]) {
+        local.heads[c] = b->next;
+        --local.sizes[c];
+        return b;
+      }
+      return ::operator new((c + 1) * granularity);
+    }
+    return ::operator new(size);
+  }
+
+  static void deallocate(void* p, std::size_t size) noexcept {
+    const std::size_t c = size_class(size);
+    if (c < classes) {
+      cache& local = local_cache();
+      if (local.sizes[c] < max_cached) {
+        local.heads[c] = ::new (p) block{local.heads[c]};
+        ++local.sizes[c];
+        return;
+      }
+      ::operator delete(p, (c + 1) * granularity);
+      return;
+    }
+    ::operator delete(p, size);
+  }
+
+private:
+  static constexpr std::size_t granularity = 64;
+  static constexpr std::size_t classes = 16;
+  static constexpr std::size_t max_cached = 64;
+
+  struct block {
+    block* next;
+  };
+
+  struct cache {
+    cache() = default;
+    cache(const cache&) = delete;
+    cache& operator=(const cache&) = delete;
+    ~cache() {
+      for (std::size_t c = 0; c < classes; ++c) {
+        while (block* b = heads[c]) {
+          heads[c] = b->next;
+          ::operator delete(b, (c + 1) * granularity);
+        }
+      }
+    }
+
+    std::array<block*, classes> heads{};
+    std::array<std::size_t, classes> sizes{};
+  };
+
+  static constexpr std::size_t size_class(std::size_t size) noexcept {
+    return (size + granularity - 1) / granularity - 1;
+  }
+
+  static cache& local_cache() noexcept {
+    thread_local cache c;
+    return c;
+  }
+};
+
+// Base of the promise types, so that their frames come from frame_allocator.
+struct frame_allocated {
+  static void* operator new(std::size_t size) {
+    return frame_allocator::allocate(size);
+  }
+
+  static void operator delete(void* p, std::size_t size) noexcept {
+    frame_allocator::deallocate(p, size);
+  }
+};
+
+template <class T>
+struct is_expected : std::false_type {};
+
+template <class T, class E>
+struct is_expected<expected<T, E>> : std::true_type {};
+
+template <class T, class E>
+class expected_task_promise : public frame_allocated {
+public:
+  expected_task<T, E> get_return_object() noexcept {
+    return expected_task<T, E>(
+        std::coroutine_handle<expected_task_promise>::from_promise(*this));
+  }
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  auto final_suspend() noexcept {
+    struct awaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<expected_task_promise> h) noexcept {
+        return h.promise().continuation();
+      }
+      void await_resume() noexcept {}
+    };
+    return awaiter{};
+  }
+
+  void return_value(expected<T, E> result) {
+    result_.emplace(std::move(result));
+  }
+
+  [[noreturn]] void unhandled_exception() noexcept { std::terminate(); }
+
+  // co_await of an expected: its value, or completes the task with its error.
+  template <class A>
+  decltype(auto) await_transform(A&& a) {
+    if constexpr (is_expected<std::remove_cvref_t<A>>::value)
+      return propagate_awaiter<A>{a, this};
+    else
+      return std::forward<A>(a);
+  }
+
+  std::coroutine_handle<> continuation() const noexcept {
+    if (continuation_)
+      return continuation_;
+    return std::noop_coroutine();
+  }
+
+  void set_continuation(std::coroutine_handle<> h) noexcept {
+    continuation_ = h;
+  }
+
+  expected<T, E>& result() noexcept { return *result_; }
+
+private:
+  // Refers to the expected, which lives until the end of the full expression
+  // that awaits it, rather than moving it into the frame. Yields a reference
+  // to the value, an rvalue one if the expected is an rvalue.
+  template <class A>
+  struct propagate_awaiter {
+    using value_type = typename std::remove_cvref_t<A>::value_type;
+
+    bool await_ready() const noexcept { return value.has_value(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> /*h*/) {
+      promise->result_.emplace(unexpect, std::forward<A>(value).error());
+      return promise->continuation();
+    }
+
+    decltype(auto) await_resume() {
+      if constexpr (!std::is_void_v<value_type>)
+        return *std::forward<A>(value);
+    }
+
+    std::remove_reference_t<A>& value;
+    expected_task_promise* promise;
+  };
+
+  std::coroutine_handle<> continuation_;
+  std::optional<expected<T, E>> result_;
+};
+
+// Runs a task to completion and sets a promise; the frame destroys itself.
+struct detached_task {
+  struct promise_type : frame_allocated {
+    detached_task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    [[noreturn]] void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+template <class T, class E>
+detached_task start_detached(expected_task<T, E> task,
+                             expected_promise<T, E> promise) {
+  promise.set_result(co_await std::move(task));
+}
+
+} // namespace detail
+
+// The task does not start until it is awaited, or passed to sync_wait. Awaiting
+// it transfers control to it directly, and its completion transfers control
+// back the same way (symmetric transfer), so chains of tasks of any depth do
+// not grow the stack. (GCC only makes the transfer a tail call when
+// optimizing.)
+template <class T, class E>
+class [[nodiscard]] expected_task {
+public:
+  using promise_type = detail::expected_task_promise<T, E>;
+  using value_type = expected<T, E>;
+
+  expected_task(expected_task&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+
+  expected_task& operator=(expected_task&& other) noexcept {
+    if (this != &other) {
+      if (handle_)
+        handle_.destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  expected_task(const expected_task&) = delete;
+  expected_task& operator=(const expected_task&) = delete;
+
+  ~expected_task() {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      bool await_ready() const noexcept { return false; }
+
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<> caller) noexcept {
+        handle.promise().set_continuation(caller);
+        return handle;
+      }
+
+      expected<T, E> await_resume() {
+        return std::move(handle.promise().result());
+      }
+
+      std::coroutine_handle<promise_type> handle;
+    };
+    return awaiter{handle_};
+  }
+
+private:
+  friend promise_type;
+
+  explicit expected_task(std::coroutine_handle<promise_type> h) noexcept
+      : handle_(h) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// Runs task on the calling thread until it completes or suspends, then waits
+// for it to complete if it was resumed elsewhere.
+template <class T, class E>
+expected<T, E> sync_wait(expected_task<T, E> task) {
+  // Always set, since an exception that escapes the task terminates.
+  expected_promise<T, E> promise{detail::unbreakable_promise_t()};
+  expected_future<T, E> future = promise.get_future();
+  detail::start_detached(std::move(task), std::move(promise));
+  return future.get();
+}
+
+} // namespace bc
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef INCLUDE_BC_FIRST_ERROR_H
+#define INCLUDE_BC_FIRST_ERROR_H
+
+#include "bc/expected.h"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+namespace bc {
+
+enum class first_error_order {
+  // The error of the task with the lowest index is kept, whatever the order
+  // in which the errors arrive.
+  lowest_index,
+  // The first error to arrive is kept.
+  first_arrival,
+};
+
+// Collects the error of a group of tasks, numbered from 0 to tasks - 1, that
+// run in parallel: one error is kept and the others are dropped. Each task
+// writes its error to a slot of its own, and the tasks only contend on one
+// compare and swap of the index of the error that is kept, so try_set never
+// blocks.
+//
+// Once an error is set, stop_requested() is true and a stop is requested on
+// get_token(), so the tasks can stop early. With lowest_index, a task with a
+// lower index than the error kept may still replace it if it fails before it
+// sees the stop.
+template <class E>
+class first_error {
+public:
+  explicit first_error(
+      std::size_t tasks,
+      first_error_order order = first_error_order::lowest_index)
+      : errors_(std::make_unique<std::optional<E>[]>(tasks)), tasks_(tasks),
+        order_(order) {}
+
+  first_error(const first_error&) = delete;
+  first_error& operator=(const first_error&) = delete;
+
+  ~first_error() = default;
+
+  std::size_t tasks() const noexcept { return tasks_; }
+
+  // Sets the error of task index, unless the error kept comes first. Each task
+  // may set one error. Returns whether this error is kept for now.
+  //
+  // An index out of range would write past the slots, so it calls
+  // std::terminate whatever the access checks are set to.
+  template <class... Args>
+  bool try_set(std::size_t index, Args&&... args) {
+    if (index >= tasks_) [[unlikely]]
+      std::terminate();
+    std::size_t kept = kept_.load(std::memory_order_relaxed);
+    if (!comes_first(index, kept))
+      return false;
+    errors_[index].emplace(std::forward<Args>(args)...);
+    while (comes_first(index, kept)) {
+      if (kept_.compare_exchange_weak(kept, index, std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+        if (kept == none)
+          stop_.request_stop();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Whether an error was set. One relaxed load.
+  bool stop_requested() const noexcept {
+    return kept_.load(std::memory_order_relaxed) != none;
+  }
+
+  // A token whose stop is requested when an error is set, for tasks that
+  // already take a std::stop_token or register a std::stop_callback.
+  std::stop_token get_token() const noexcept { return stop_.get_token(); }
+
+  // The index of the task whose error is kept, if any.
+  std::optional<std::size_t> index() const noexcept {
+    std::size_t kept = kept_.load(std::memory_order_acquire);
+    if (kept == none)
+      return std::nullopt;
+    return kept;
+  }
+
+  // The error kept, if any. To be called once all the tasks have finished.
+  expected<void, E> result() const& {
+    std::size_t kept = kept_.load(std::memory_order_acquire);
+    if (kept == none)
+      return {};
+    return expected<void, E>(unexpect, *errors_[kept]);
+  }
+
+  expected<void, E> result() && {
+    std::size_t kept = kept_.load(std::memory_order_acquire);
+    if (kept == none)
+      return {};
+    return expected<void, E>(unexpect, std::move(*errors_[kept]));
+  }
+
+private:
+  static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+  bool comes_first(std::size_t index, std::size_t kept) const noexcept {
+    if (order_ == first_error_order::lowest_index)
+      return index < kept;
+    return kept == none;
+  }
+
+  std::atomic<std::size_t> kept_{none};
+  // NOLINTNEXTLINE(*-avoid-c-arrays): One slot per task
+  std::unique_ptr<std::optional<E>[]> errors_;
+  std::size_t tasks_;
+  first_error_order order_;
+  std::stop_source stop_;
+};
+
+} // namespace bc
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef INCLUDE_BC_RELOCATABLE_VECTOR_H
+#define INCLUDE_BC_RELOCATABLE_VECTOR_H
+
+#include "bc/expected.h"
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace bc {
+
+// Marks std::vector with the default allocator as trivially relocatable, so
+// that assignment and swap of an expected holding one copy bytes. Kept out of
+// bc/expected.h so that it does not include <vector>.
+//
+// Include it in every translation unit that uses an expected of a vector, or
+// in none: a specialization that some translation units see and others do not
+// makes the program ill-formed.
+//
+// The debug mode vector of libstdc++ registers its iterators with the
+// container, so it is not trivially relocatable.
+#ifndef _GLIBCXX_DEBUG
+template <class T>
+struct is_trivially_relocatable<std::vector<T, std::allocator<T>>>
+    : std::true_type {};
+#endif
+
+} // namespace bc
+
+#endif
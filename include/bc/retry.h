@@ -0,0 +1,141 @@
+#ifndef INCLUDE_BC_RETRY_H
+#define INCLUDE_BC_RETRY_H
+
+#include "bc/expected.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace bc {
+
+struct retry_options {
+  using duration = std::chrono::nanoseconds;
+
+  // Attempts in all, the first one included.
+  std::size_t max_attempts = 3;
+  // The delay before the first retry. Each next delay is multiplier times
+  // longer, up to max_delay.
+  duration initial_delay = std::chrono::milliseconds(10);
+  double multiplier = 2.0;
+  duration max_delay = std::chrono::seconds(1);
+  // Each delay is drawn uniformly from [delay * (1 - jitter), delay], so that
+  // callers that failed together do not retry together. 1 is full jitter, 0
+  // none.
+  double jitter = 1.0;
+  // No retry starts later than this after the first attempt failed.
+  duration deadline = duration::max();
+};
+
+struct retry_always {
+  template <class E>
+  bool operator()(const E& /*unused*/) const noexcept {
+    return true;
+  }
+};
+
+struct thread_sleeper {
+  void operator()(std::chrono::nanoseconds d) const {
+    std::this_thread::sleep_for(d);
+  }
+};
+
+// Retryable is called with the error of a failed attempt and says whether to
+// try again. Clock needs a now() member; sleep is called with each delay.
+// Both can be replaced in tests, so that they do not sleep.
+template <class Retryable = retry_always,
+          class Clock = std::chrono::steady_clock,
+          class Sleeper = thread_sleeper>
+struct retry_policy {
+  retry_options options;
+  [[no_unique_address]] Retryable retryable{};
+  [[no_unique_address]] Clock clock{};
+  [[no_unique_address]] Sleeper sleep{};
+};
+
+namespace detail {
+
+// Saturates at nanoseconds::max(), which is what max_delay is set to for no
+// cap. As a double it rounds up to 2^63, so the cast would overflow.
+inline std::chrono::nanoseconds to_nanoseconds(double ns) noexcept {
+  constexpr auto limit =
+      static_cast<double>(std::chrono::nanoseconds::max().count());
+  if (ns >= limit)
+    return std::chrono::nanoseconds::max();
+  return std::chrono::nanoseconds(static_cast<std::int64_t>(ns));
+}
+
+inline std::chrono::nanoseconds jittered(double delay, double jitter) {
+  if (jitter <= 0.0)
+    return to_nanoseconds(delay);
+  thread_local std::minstd_rand engine(std::random_device{}());
+  std::uniform_real_distribution<double> factor(1.0 - std::min(jitter, 1.0),
+                                                1.0);
+  return to_nanoseconds(delay * factor(engine));
+}
+
+// Kept out of line, so that retry only adds a test of the first result to the
+// call.
+template <class Policy, class F, class R>
+[[gnu::noinline]] R retry_failed(const Policy& policy, F& f, R r) {
+  const retry_options& o = policy.options;
+  if (o.max_attempts <= 1 || !policy.retryable(std::as_const(r).error()))
+    return r;
+  const auto start = policy.clock.now();
+  auto delay = static_cast<double>(o.initial_delay.count());
+  for (std::size_t attempt = 1; attempt < o.max_attempts; ++attempt) {
+    const std::chrono::nanoseconds d = jittered(delay, o.jitter);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        policy.clock.now() - start);
+    if (d > o.deadline - elapsed)
+      return r;
+    policy.sleep(d);
+    r = std::invoke(f);
+    if (r.has_value() || !policy.retryable(std::as_const(r).error()))
+      return r;
+    delay = std::min(delay * o.multiplier,
+                     static_cast<double>(o.max_delay.count()));
+  }
+  return r;
+}
+
+} // namespace detail
+
+// Calls f, which returns an expected, until it succeeds, fails with an error
+// that is not retryable, or the attempts or the time run out. Returns the last
+// result. Between attempts it sleeps with exponential backoff and jitter:
+//
+//   auto r = bc::retry(bc::retry_policy{{.max_attempts = 5}, is_transient},
+//                      [&] { return fetch(url); });
+//
+// When the first attempt succeeds, this is f() and one test of its result: the
+// clock is not read, and the result is returned without a move.
+template <class Retryable, class Clock, class Sleeper, class F>
+std::invoke_result_t<F&> retry(
+    const retry_policy<Retryable, Clock, Sleeper>& policy, F&& f) {
+  using R = std::invoke_result_t<F&>;
+  if constexpr (std::is_trivially_copyable_v<R>) {
+    // Returned in registers when it is small enough, which a result that may
+    // be passed to the slow path by reference would not be.
+    R r = std::invoke(f);
+    if (r.has_value()) [[likely]]
+      return r;
+    return detail::retry_failed(policy, f, r);
+  } else {
+    // One return statement, so that r is constructed in the return slot.
+    R r = std::invoke(f);
+    if (!r.has_value()) [[unlikely]]
+      r = detail::retry_failed(policy, f, std::move(r));
+    return r;
+  }
+}
+
+} // namespace bc
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef INCLUDE_BC_WHEN_ALL_H
+#define INCLUDE_BC_WHEN_ALL_H
+
+#include "bc/expected.h"
+#include "bc/first_error.h"
+#include "bc/work_stealing_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stop_token>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+// Structured fan-out of callables that return an expected on a
+// work_stealing_pool. Both combinators return once every callable has either
+// run or been skipped, so the callables and the results they refer to may live
+// on the caller's stack.
+//
+// A callable is invoked with a std::stop_token if it accepts one, and without
+// arguments otherwise. Callables that have not started when the outcome is
+// decided are skipped; those that take a token can stop early. Callables must
+// not throw: they report errors through their expected.
+
+namespace bc {
+
+namespace detail {
+
+template <class F>
+decltype(auto) invoke_task(F& f, std::stop_token token) {
+  if constexpr (std::is_invocable_v<F&, std::stop_token>)
+    return std::invoke(f, std::move(token));
+  else
+    return std::invoke(f);
+}
+
+template <class F>
+using task_result_t = std::remove_cvref_t<decltype(invoke_task(
+    std::declval<F&>(), std::declval<std::stop_token>()))>;
+
+// void values are kept as std::monostate in the tuple of when_all.
+template <class T>
+using when_all_value_t =
+    std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+// A job that runs one callable of a combinator: State::run<I> for its index.
+template <class State>
+struct combinator_job : pool_job {
+  State* state = nullptr;
+  std::size_t index = 0;
+};
+
+template <class State, std::size_t... I>
+void run_combinator(State& state, std::index_sequence<I...> /*unused*/) {
+  using job = combinator_job<State>;
+  std::array<job, sizeof...(I)> jobs;
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    jobs[i].state = &state;
+    jobs[i].index = i;
+    jobs[i].run = [](pool_job& j) {
+      constexpr std::array<void (*)(State&), sizeof...(I)> table = {
+          &State::template run<I>...};
+      auto& self = static_cast<job&>(j);
+      table[self.index](*self.state);
+    };
+  }
+  // The first callable runs on the calling thread; the others are queued in
+  // reverse so that the calling thread, popping its own deque, runs them in
+  // order while thieves take the last ones.
+  for (std::size_t i = jobs.size(); i-- > 1;)
+    state.pool.submit(jobs[i]);
+  jobs[0].run(jobs[0]);
+  state.pool.wait_until([&] {
+    return state.remaining.load(std::memory_order_acquire) == 0;
+  });
+}
+
+template <class E, class... F>
+struct when_all_state {
+  explicit when_all_state(work_stealing_pool& p, F&... f) : pool(p), fs(f...) {}
+
+  template <std::size_t I>
+  static void run(when_all_state& s) {
+    if (!s.errors.stop_requested()) {
+      auto r = invoke_task(std::get<I>(s.fs), s.errors.get_token());
+      if (!r.has_value()) {
+        s.errors.try_set(I, std::move(r.error()));
+      } else if constexpr (std::is_void_v<
+                               typename decltype(r)::value_type>) {
+        std::get<I>(s.values).emplace();
+      } else {
+        std::get<I>(s.values).emplace(std::move(*r));
+      }
+    }
+    s.remaining.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  work_stealing_pool& pool;
+  std::tuple<F&...> fs;
+  std::tuple<
+      std::optional<when_all_value_t<typename task_result_t<F>::value_type>>...>
+      values;
+  first_error<E> errors{sizeof...(F)};
+  std::atomic<std::size_t> remaining{sizeof...(F)};
+};
+
+template <class T, class E, class... F>
+struct when_any_state {
+  static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+  explicit when_any_state(work_stealing_pool& p, F&... f) : pool(p), fs(f...) {}
+
+  template <std::size_t I>
+  static void run(when_any_state& s) {
+    if (!s.stop.stop_requested()) {
+      auto r = invoke_task(std::get<I>(s.fs), s.stop.get_token());
+      if (!r.has_value()) {
+        s.errors.try_set(I, std::move(r.error()));
+      } else {
+        std::size_t expected_winner = none;
+        if (s.winner.compare_exchange_strong(expected_winner, I,
+                                             std::memory_order_acq_rel)) {
+          if constexpr (std::is_void_v<T>)
+            s.value.emplace();
+          else
+            s.value.emplace(std::move(*r));
+          s.stop.request_stop();
+        }
+      }
+    }
+    s.remaining.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  work_stealing_pool& pool;
+  std::tuple<F&...> fs;
+  std::optional<when_all_value_t<T>> value;
+  std::atomic<std::size_t> winner{none};
+  std::stop_source stop;
+  first_error<E> errors{sizeof...(F)};
+  std::atomic<std::size_t> remaining{sizeof...(F)};
+};
+
+} // namespace detail
+
+// Runs every callable and returns all their values, or the error of the
+// callable with the lowest index among those that failed. The first error
+// stops the callables that have not finished.
+template <class F0, class... F>
+expected<std::tuple<detail::when_all_value_t<
+             typename detail::task_result_t<F0>::value_type>,
+                    detail::when_all_value_t<
+                        typename detail::task_result_t<F>::value_type>...>,
+         typename detail::task_result_t<F0>::error_type>
+when_all(work_stealing_pool& pool, F0&& f0, F&&... f) {
+  using E = typename detail::task_result_t<F0>::error_type;
+  static_assert(
+      (std::is_same_v<typename detail::task_result_t<F>::error_type, E> &&
+       ...),
+      "all the callables must have the same error type");
+  using state_type =
+      detail::when_all_state<E, std::remove_reference_t<F0>,
+                             std::remove_reference_t<F>...>;
+  state_type state(pool, f0, f...);
+  detail::run_combinator(state,
+                         std::make_index_sequence<sizeof...(F) + 1>());
+  if (auto error = std::move(state.errors).result(); !error.has_value())
+    return unexpected(std::move(error.error()));
+  return std::apply(
+      [](auto&... v) {
+        return std::tuple<typename std::remove_reference_t<
+            decltype(v)>::value_type...>(std::move(*v)...);
+      },
+      state.values);
+}
+
+// Runs the callables until one succeeds, and returns its value. The first
+// success stops the others. If all of them fail, returns the error of the one
+// with the lowest index. The callables must return the same expected type.
+template <class F0, class... F>
+detail::task_result_t<F0> when_any(work_stealing_pool& pool, F0&& f0,
+                                   F&&... f) {
+  using R = detail::task_result_t<F0>;
+  static_assert((std::is_same_v<detail::task_result_t<F>, R> && ...),
+                "all the callables must return the same expected type");
+  using T = typename R::value_type;
+  using E = typename R::error_type;
+  using state_type =
+      detail::when_any_state<T, E, std::remove_reference_t<F0>,
+                             std::remove_reference_t<F>...>;
+  state_type state(pool, f0, f...);
+  detail::run_combinator(state,
+                         std::make_index_sequence<sizeof...(F) + 1>());
+  if (state.winner.load(std::memory_order_acquire) == state_type::none)
+    return unexpected(std::move(std::move(state.errors).result().error()));
+  if constexpr (std::is_void_v<T>)
+    return {};
+  else
+    return R(std::in_place, std::move(*state.value));
+}
+
+} // namespace bc
+
+#endif
@@ -0,0 +1,307 @@
+#ifndef INCLUDE_BC_WORK_STEALING_POOL_H
+#define INCLUDE_BC_WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bc {
+
+// A unit of work for work_stealing_pool. The pool does not own jobs: whoever
+// submits one keeps it alive until it has run, which lets combinators keep
+// their jobs on the stack.
+struct pool_job {
+  void (*run)(pool_job& job) = nullptr;
+  // Used by the pool while the job is queued.
+  pool_job* next = nullptr;
+};
+
+namespace detail {
+
+// Chase-Lev deque of fixed capacity (the C11 formulation of Lê, Pop, Cohen
+// and Zappa Nardelli). The owner pushes and pops at the bottom; other threads
+// steal from the top.
+class chase_lev_deque {
+public:
+  explicit chase_lev_deque(std::size_t capacity)
+      : mask_(static_cast<std::int64_t>(std::bit_ceil(capacity)) - 1),
+        buffer_(std::make_unique<std::atomic<pool_job*>[]>(
+            static_cast<std::size_t>(mask_ + 1))) {}
+
+  // Owner only. Returns false if the deque is full.
+  bool push(pool_job* job) noexcept {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t > mask_)
+      return false;
+    slot(b).store(job, std::memory_order_relaxed);
+    // A release store rather than the paper's release fence and relaxed
+    // store: the same on x86 and ARM, and understood by ThreadSanitizer.
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Owner only.
+  pool_job* pop() noexcept {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+    pool_job* job = nullptr;
+    if (t <= b) {
+      job = slot(b).load(std::memory_order_relaxed);
+      if (t == b) {
+        // The last job: race with thieves for it.
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+          job = nullptr;
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  // Any thread. Returns nullptr if the deque is empty or another thread won
+  // the job.
+  pool_job* steal() noexcept {
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b)
+      return nullptr;
+    pool_job* job = slot(t).load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return nullptr;
+    return job;
+  }
+
+private:
+  std::atomic<pool_job*>& slot(std::int64_t i) noexcept {
+    return buffer_[static_cast<std::size_t>(i & mask_)];
+  }
+
+  alignas(64) std::atomic<std::int64_t> top_{0};
+  alignas(64) std::atomic<std::int64_t> bottom_{0};
+  const std::int64_t mask_;
+  // NOLINTNEXTLINE(*-avoid-c-arrays): Ring buffer
+  std::unique_ptr<std::atomic<pool_job*>[]> buffer_;
+};
+
+} // namespace detail
+
+// A fixed set of worker threads, each with a Chase-Lev deque. A job submitted
+// by a worker goes to its own deque, and idle workers steal from the others;
+// a job submitted by any other thread goes to a shared queue. Idle workers
+// sleep on an atomic wait.
+//
+// Threads that wait for jobs to finish should do so with wait_until, which
+// runs pending jobs in the meantime. A worker that waits for jobs it spawned
+// thus keeps working, and nested fork-join does not deadlock.
+class work_stealing_pool {
+public:
+  // deque_capacity is the number of jobs a worker can have queued; beyond it,
+  // a worker runs the jobs it submits immediately.
+  explicit work_stealing_pool(
+      std::size_t threads = std::max(1U, std::thread::hardware_concurrency()),
+      std::size_t deque_capacity = 1024) {
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+      workers_.push_back(std::make_unique<worker>(deque_capacity));
+    for (std::size_t i = 0; i < threads; ++i)
+      workers_[i]->thread = std::thread([this, i] { work(i); });
+  }
+
+  work_stealing_pool(const work_stealing_pool&) = delete;
+  work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+  // Runs the jobs still queued, then joins the workers.
+  ~work_stealing_pool() {
+    stop_.store(true, std::memory_order_relaxed);
+    wake_.fetch_add(1, std::memory_order_release);
+    wake_.notify_all();
+    for (auto& w : workers_)
+      w->thread.join();
+  }
+
+  std::size_t size() const noexcept { return workers_.size(); }
+
+  // Queues job. It must stay alive until it has run.
+  void submit(pool_job& job) {
+    worker* self = current_worker();
+    if (self != nullptr) {
+      if (!self->jobs.push(&job)) {
+        job.run(job);
+        return;
+      }
+    } else {
+      std::lock_guard lock(shared_mutex_);
+      job.next = nullptr;
+      if (shared_tail_ != nullptr)
+        shared_tail_->next = &job;
+      else
+        shared_head_ = &job;
+      shared_tail_ = &job;
+      shared_size_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) != 0) {
+      wake_.fetch_add(1, std::memory_order_relaxed);
+      wake_.notify_one();
+    }
+  }
+
+  // Runs one queued job on the calling thread, if there is one.
+  bool run_one() {
+    pool_job* job = find_job(current_worker());
+    if (job == nullptr)
+      return false;
+    job->run(*job);
+    return true;
+  }
+
+  // Runs queued jobs until done() is true.
+  template <class Pred>
+  void wait_until(Pred done) {
+    int idle = 0;
+    while (!done()) {
+      if (run_one()) {
+        idle = 0;
+      } else if (++idle < spins) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+private:
+  static constexpr int spins = 64;
+
+  struct worker {
+    explicit worker(std::size_t capacity) : jobs(capacity) {}
+
+    detail::chase_lev_deque jobs;
+    std::thread thread;
+  };
+
+  struct current {
+    work_stealing_pool* pool = nullptr;
+    worker* self = nullptr;
+  };
+
+  static current& current_thread() noexcept {
+    thread_local current c;
+    return c;
+  }
+
+  worker* current_worker() const noexcept {
+    const current& c = current_thread();
+    return c.pool == this ? c.self : nullptr;
+  }
+
+  pool_job* pop_shared() {
+    if (shared_size_.load(std::memory_order_relaxed) == 0)
+      return nullptr;
+    std::lock_guard lock(shared_mutex_);
+    pool_job* job = shared_head_;
+    if (job != nullptr) {
+      shared_head_ = job->next;
+      if (shared_head_ == nullptr)
+        shared_tail_ = nullptr;
+      shared_size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  // Own deque first, then the shared queue, then the other workers, starting
+  // from a random one.
+  pool_job* find_job(worker* self) {
+    if (self != nullptr) {
+      if (pool_job* job = self->jobs.pop())
+        return job;
+    }
+    if (pool_job* job = pop_shared())
+      return job;
+    const std::size_t n = workers_.size();
+    const std::size_t first = next_random() % n;
+    for (std::size_t i = 0; i < n; ++i) {
+      worker& victim = *workers_[(first + i) % n];
+      if (&victim == self)
+        continue;
+      if (pool_job* job = victim.jobs.steal())
+        return job;
+    }
+    return nullptr;
+  }
+
+  static std::uint32_t next_random() noexcept {
+    // xorshift32
+    thread_local std::uint32_t state = static_cast<std::uint32_t>(
+        std::hash<std::thread::id>()(std::this_thread::get_id()) | 1U);
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  void work(std::size_t index) {
+    worker* self = workers_[index].get();
+    current_thread() = current{this, self};
+    int idle = 0;
+    for (;;) {
+      if (pool_job* job = find_job(self)) {
+        job->run(*job);
+        idle = 0;
+        continue;
+      }
+      if (++idle < spins) {
+        std::this_thread::yield();
+        continue;
+      }
+      // Announces the sleep, then looks for work once more: a submit either
+      // sees the announcement and wakes this worker, or its job is found.
+      sleeping_.fetch_add(1, std::memory_order_relaxed);
+      std::uint32_t wake = wake_.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      pool_job* job = find_job(self);
+      if (job == nullptr) {
+        if (stop_.load(std::memory_order_relaxed)) {
+          sleeping_.fetch_sub(1, std::memory_order_relaxed);
+          return;
+        }
+        wake_.wait(wake, std::memory_order_acquire);
+      }
+      sleeping_.fetch_sub(1, std::memory_order_relaxed);
+      if (job != nullptr)
+        job->run(*job);
+      idle = 0;
+    }
+  }
+
+  std::vector<std::unique_ptr<worker>> workers_;
+
+  std::mutex shared_mutex_;
+  pool_job* shared_head_ = nullptr;
+  pool_job* shared_tail_ = nullptr;
+  std::atomic<std::size_t> shared_size_{0};
+
+  std::atomic<std::uint32_t> wake_{0};
+  std::atomic<int> sleeping_{0};
+  std::atomic<bool> stop_{false};
+};
+
+} // namespace bc
+
+#endif
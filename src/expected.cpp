@@ -0,0 +1,19 @@
+#include "bc/expected.h"
+
+namespace bc {
+
+namespace detail {
+
+template struct expected_operations_base<void, std::error_code>;
+template struct expected_operations_base<int, std::error_code>;
+template struct expected_operations_base<std::string, std::string>;
+template struct expected_operations_base<std::size_t, std::errc>;
+
+} // namespace detail
+
+template class expected<void, std::error_code>;
+template class expected<int, std::error_code>;
+template class expected<std::string, std::string>;
+template class expected<std::size_t, std::errc>;
+
+} // namespace bc
@@ -0,0 +1,183 @@
+#include "bc/atomic_expected.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Shard_error : std::uint32_t { unavailable = 1, overloaded };
+
+struct Wide_error {
+  std::uint32_t code;
+  std::uint32_t detail;
+};
+
+struct Large {
+  std::uint64_t a;
+  std::uint64_t b;
+  std::uint64_t c;
+  std::uint64_t d;
+};
+
+bool operator==(const Large& x, const Large& y) {
+  return x.a == y.a && x.b == y.b && x.c == y.c && x.d == y.d;
+}
+
+bool operator==(const Wide_error& x, const Wide_error& y) {
+  return x.code == y.code && x.detail == y.detail;
+}
+
+// The counter in each value type.
+std::uint64_t key(std::uint32_t x) { return x; }
+std::uint64_t key(std::uint64_t x) { return x; }
+std::uint64_t key(const Large& x) { return x.a; }
+
+// Value and error of up to 8 bytes: one word.
+using Small = atomic_expected<std::uint32_t, Shard_error>;
+using Void = atomic_expected<void, Shard_error>;
+// 8 bytes and the has value byte: two words.
+using Medium = atomic_expected<std::uint64_t, Wide_error>;
+// 32 bytes: always the sequence lock.
+using Big = atomic_expected<Large, Shard_error>;
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(atomic_expected, lock_free) {
+  static_assert(Small::is_always_lock_free);
+  static_assert(Void::is_always_lock_free);
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && defined(__AVX__)
+  static_assert(Medium::is_always_lock_free);
+#else
+  static_assert(!Medium::is_always_lock_free);
+#endif
+  static_assert(!Big::is_always_lock_free);
+
+  Small s;
+  Big b;
+  ASSERT_TRUE(s.is_lock_free());
+  ASSERT_FALSE(b.is_lock_free());
+}
+
+namespace {
+
+template <class A, class V, class E>
+void check_operations(const V& v1, const V& v2, const E& e) {
+  using value_type = typename A::value_type;
+  A a(v1);
+  ASSERT_EQ(a.load(), value_type(v1));
+
+  a.store(unexpected(e));
+  ASSERT_EQ(a.load(), unexpected(e));
+
+  value_type old = a.exchange(v2);
+  ASSERT_EQ(old, unexpected(e));
+  ASSERT_EQ(a.load(), value_type(v2));
+
+  value_type expected_value(v1);
+  ASSERT_FALSE(a.compare_exchange_strong(expected_value, unexpected(e)));
+  ASSERT_EQ(expected_value, value_type(v2));
+  ASSERT_TRUE(a.compare_exchange_strong(expected_value, unexpected(e)));
+  ASSERT_EQ(a.load(), unexpected(e));
+
+  expected_value = unexpected(e);
+  ASSERT_TRUE(a.compare_exchange_weak(expected_value, v1));
+  a = v2;
+  ASSERT_EQ(static_cast<value_type>(a), value_type(v2));
+}
+
+} // namespace
+
+TEST(atomic_expected, operations) {
+  check_operations<Small>(std::uint32_t{1}, std::uint32_t{2},
+                          Shard_error::overloaded);
+  check_operations<Medium>(std::uint64_t{1}, std::uint64_t{2},
+                           Wide_error{3, 4});
+  check_operations<Big>(Large{1, 2, 3, 4}, Large{5, 6, 7, 8},
+                        Shard_error::unavailable);
+}
+
+TEST(atomic_expected, void_value) {
+  Void a;
+  ASSERT_TRUE(a.load().has_value());
+  a.store(unexpected(Shard_error::unavailable));
+  ASSERT_EQ(a.load().error(), Shard_error::unavailable);
+  expected<void, Shard_error> expected_value;
+  ASSERT_FALSE(a.compare_exchange_strong(expected_value, {}));
+  ASSERT_EQ(expected_value.error(), Shard_error::unavailable);
+  ASSERT_TRUE(a.compare_exchange_strong(expected_value, {}));
+  ASSERT_TRUE(a.load().has_value());
+}
+
+TEST(atomic_expected, value_and_error_with_same_bytes) {
+  // The value 1 and the error 1 differ only in the has value byte.
+  Small a(std::uint32_t{1});
+  expected<std::uint32_t, Shard_error> expected_value =
+      unexpected(Shard_error::unavailable);
+  ASSERT_FALSE(a.compare_exchange_strong(expected_value, std::uint32_t{2}));
+  ASSERT_EQ(expected_value, std::uint32_t{1});
+}
+
+namespace {
+
+template <class A, class Make>
+void check_concurrent_increments(Make make) {
+  constexpr int threads = 4;
+  constexpr int increments = 10000;
+  A a(make(0));
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&] {
+      for (int i = 0; i < increments; ++i) {
+        auto current = a.load();
+        while (!a.compare_exchange_weak(current, make(key(*current) + 1))) {
+        }
+      }
+    });
+  }
+  for (std::thread& w : workers)
+    w.join();
+  ASSERT_EQ(key(*a.load()), threads * increments);
+}
+
+} // namespace
+
+TEST(atomic_expected, concurrent_compare_exchange) {
+  check_concurrent_increments<Small>(
+      [](std::uint64_t n) { return static_cast<std::uint32_t>(n); });
+  check_concurrent_increments<Medium>([](std::uint64_t n) { return n; });
+  check_concurrent_increments<Big>(
+      [](std::uint64_t n) { return Large{n, n, n, n}; });
+}
+
+TEST(atomic_expected, no_torn_reads) {
+  // Every stored value has equal fields; a torn read would not.
+  Big a(Large{0, 0, 0, 0});
+  std::atomic<bool> done{false};
+  std::atomic<bool> torn{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; ++t) {
+    readers.emplace_back([&] {
+      while (!done.load(std::memory_order_relaxed)) {
+        Large v = *a.load();
+        if (v.a != v.b || v.b != v.c || v.c != v.d)
+          torn.store(true);
+      }
+    });
+  }
+  for (std::uint64_t n = 1; n <= 100000; ++n)
+    a.store(Large{n, n, n, n});
+  done.store(true);
+  for (std::thread& r : readers)
+    r.join();
+  ASSERT_FALSE(torn.load());
+}
+
+// NOLINTEND(*-avoid-magic-numbers): Test values
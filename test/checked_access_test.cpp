@@ -0,0 +1,95 @@
+#include "bc/expected.h"
+
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+struct Obj {
+  int x;
+};
+
+#if BC_STD_EXPECTED_ACCESS_CHECK == BC_STD_EXPECTED_ACCESS_ASSERT
+constexpr const char* has_value_failed =
+    "bc::expected: Access check `has_value\\(\\)' failed";
+constexpr const char* has_error_failed =
+    "bc::expected: Access check `!has_value\\(\\)' failed";
+#else
+constexpr const char* has_value_failed = "";
+constexpr const char* has_error_failed = "";
+#endif
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(checked_access, active_member) {
+  {
+    expected<Obj, int> e(std::in_place, 1);
+    const expected<Obj, int>& ce = e;
+    ASSERT_EQ(e->x, 1);
+    ASSERT_EQ(ce->x, 1);
+    ASSERT_EQ((*e).x, 1);
+    ASSERT_EQ((*ce).x, 1);
+    ASSERT_EQ((*std::move(ce)).x, 1);
+    ASSERT_EQ((*std::move(e)).x, 1);
+  }
+  {
+    expected<Obj, int> e(unexpect, 2);
+    const expected<Obj, int>& ce = e;
+    ASSERT_EQ(e.error(), 2);
+    ASSERT_EQ(ce.error(), 2);
+    ASSERT_EQ(std::move(ce).error(), 2);
+    ASSERT_EQ(std::move(e).error(), 2);
+  }
+  {
+    expected<void, int> e(unexpect, 3);
+    ASSERT_EQ(e.error(), 3);
+  }
+}
+
+TEST(checked_access, constexpr_active_member) {
+  static_assert(*expected<int, int>(1) == 1);
+  static_assert(expected<int, int>(unexpect, 2).error() == 2);
+  static_assert(expected<void, int>(unexpect, 3).error() == 3);
+}
+
+#if BC_STD_EXPECTED_ACCESS_CHECK != BC_STD_EXPECTED_ACCESS_UNCHECKED
+
+TEST(checked_access_death, member_access_operator) {
+  expected<Obj, int> e(unexpect, 1);
+  const expected<Obj, int>& ce = e;
+  EXPECT_DEATH((void)e->x, has_value_failed);
+  EXPECT_DEATH((void)ce->x, has_value_failed);
+}
+
+TEST(checked_access_death, indirection_operator) {
+  expected<Obj, int> e(unexpect, 1);
+  const expected<Obj, int>& ce = e;
+  EXPECT_DEATH((void)*e, has_value_failed);
+  EXPECT_DEATH((void)*ce, has_value_failed);
+  EXPECT_DEATH((void)*std::move(ce), has_value_failed);
+  EXPECT_DEATH((void)*std::move(e), has_value_failed);
+}
+
+TEST(checked_access_death, error) {
+  {
+    expected<Obj, int> e(std::in_place, 1);
+    const expected<Obj, int>& ce = e;
+    EXPECT_DEATH((void)e.error(), has_error_failed);
+    EXPECT_DEATH((void)ce.error(), has_error_failed);
+    EXPECT_DEATH((void)std::move(ce).error(), has_error_failed);
+    EXPECT_DEATH((void)std::move(e).error(), has_error_failed);
+  }
+  {
+    expected<void, int> e;
+    EXPECT_DEATH((void)e.error(), has_error_failed);
+  }
+}
+
+#endif
+
+// NOLINTEND(*-avoid-magic-numbers): Test values
@@ -0,0 +1,233 @@
+#include "bc/circuit_breaker.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+using namespace std::chrono_literals;
+
+namespace {
+
+enum class Db_error { timeout = 1, unavailable };
+
+// A clock that only moves when the test advances it.
+struct Manual_clock {
+  using duration = std::chrono::nanoseconds;
+  using time_point = std::chrono::time_point<Manual_clock, duration>;
+
+  time_point now() const noexcept { return time_point(*elapsed); }
+
+  const duration* elapsed;
+};
+
+using manual_breaker = circuit_breaker<Db_error, Manual_clock>;
+
+// A Manual_clock that another thread may advance.
+struct Shared_clock {
+  using duration = std::chrono::nanoseconds;
+  using time_point = std::chrono::time_point<Shared_clock, duration>;
+
+  time_point now() const noexcept {
+    return time_point(duration(elapsed->load(std::memory_order_relaxed)));
+  }
+
+  const std::atomic<std::int64_t>* elapsed;
+};
+
+expected<int, Db_error> ok() { return 1; }
+
+expected<int, Db_error> fail() { return unexpected(Db_error::timeout); }
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(circuit_breaker, opens_on_failure_rate) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_breaker breaker(Db_error::unavailable,
+                         {.failure_rate = 0.5, .min_calls = 10}, {&elapsed});
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(breaker.call(ok).has_value());
+    EXPECT_EQ(breaker.call(fail).error(), Db_error::timeout);
+  }
+  // Not enough calls yet.
+  EXPECT_EQ(breaker.state(), circuit_state::closed);
+  EXPECT_TRUE(breaker.call(ok).has_value());
+  EXPECT_FALSE(breaker.call(fail).has_value());
+  EXPECT_EQ(breaker.state(), circuit_state::open);
+
+  int calls = 0;
+  auto r = breaker.call([&] {
+    ++calls;
+    return ok();
+  });
+  EXPECT_EQ(calls, 0);
+  EXPECT_EQ(r.error(), Db_error::unavailable);
+}
+
+TEST(circuit_breaker, stays_closed_below_rate) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_breaker breaker(Db_error::unavailable,
+                         {.failure_rate = 0.5, .min_calls = 10}, {&elapsed});
+  for (int i = 0; i < 100; ++i) {
+    static_cast<void>(breaker.call(ok));
+    static_cast<void>(breaker.call(ok));
+    static_cast<void>(breaker.call(fail));
+  }
+  EXPECT_EQ(breaker.state(), circuit_state::closed);
+}
+
+TEST(circuit_breaker, old_failures_leave_the_window) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_breaker breaker(
+      Db_error::unavailable,
+      {.failure_rate = 0.5, .min_calls = 10, .window = 8s, .buckets = 8},
+      {&elapsed});
+  for (int i = 0; i < 9; ++i)
+    static_cast<void>(breaker.call(fail));
+  elapsed = 9s;
+  // The nine failures are forgotten, so one more does not open the breaker.
+  static_cast<void>(breaker.call(fail));
+  EXPECT_EQ(breaker.state(), circuit_state::closed);
+  for (int i = 0; i < 9; ++i)
+    static_cast<void>(breaker.call(fail));
+  EXPECT_EQ(breaker.state(), circuit_state::open);
+}
+
+TEST(circuit_breaker, successes_after_a_quiet_spell_are_kept) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_breaker breaker(
+      Db_error::unavailable,
+      {.failure_rate = 0.5, .min_calls = 20, .window = 8s, .buckets = 8},
+      {&elapsed});
+  elapsed = 20s;
+  // Fewer successes than slide the window, then failures at the same time: a
+  // failure rate of 25%.
+  for (int i = 0; i < 60; ++i)
+    static_cast<void>(breaker.call(ok));
+  for (int i = 0; i < 20; ++i)
+    static_cast<void>(breaker.call(fail));
+  EXPECT_EQ(breaker.state(), circuit_state::closed);
+}
+
+TEST(circuit_breaker, probe_closes) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_breaker breaker(
+      Db_error::unavailable,
+      {.min_calls = 1, .open_duration = 5s}, {&elapsed});
+  static_cast<void>(breaker.call(fail));
+  ASSERT_EQ(breaker.state(), circuit_state::open);
+  elapsed = 4s;
+  EXPECT_EQ(breaker.call(ok).error(), Db_error::unavailable);
+
+  elapsed = 5s;
+  auto r = breaker.call([&] {
+    EXPECT_EQ(breaker.state(), circuit_state::half_open);
+    // Only the probe goes through.
+    EXPECT_EQ(breaker.call(ok).error(), Db_error::unavailable);
+    return ok();
+  });
+  EXPECT_TRUE(r.has_value());
+  EXPECT_EQ(breaker.state(), circuit_state::closed);
+  EXPECT_TRUE(breaker.call(ok).has_value());
+}
+
+TEST(circuit_breaker, failed_probe_reopens) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_breaker breaker(
+      Db_error::unavailable,
+      {.min_calls = 1, .open_duration = 5s}, {&elapsed});
+  static_cast<void>(breaker.call(fail));
+  elapsed = 5s;
+  EXPECT_EQ(breaker.call(fail).error(), Db_error::timeout);
+  EXPECT_EQ(breaker.state(), circuit_state::open);
+  // Open for another open_duration from the probe.
+  elapsed = 9s;
+  EXPECT_EQ(breaker.call(ok).error(), Db_error::unavailable);
+  elapsed = 10s;
+  EXPECT_TRUE(breaker.call(ok).has_value());
+}
+
+TEST(circuit_breaker, throwing_probe_reopens) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_breaker breaker(
+      Db_error::unavailable,
+      {.min_calls = 1, .open_duration = 5s}, {&elapsed});
+  static_cast<void>(breaker.call(fail));
+  elapsed = 5s;
+  EXPECT_THROW(static_cast<void>(breaker.call(
+                   []() -> expected<int, Db_error> {
+                     throw std::runtime_error("driver");
+                   })),
+               std::runtime_error);
+  EXPECT_EQ(breaker.state(), circuit_state::open);
+  elapsed = 10s;
+  EXPECT_TRUE(breaker.call(ok).has_value());
+}
+
+TEST(circuit_breaker, concurrent_failures_open) {
+  circuit_breaker<Db_error> breaker(Db_error::unavailable,
+                                    {.failure_rate = 0.5, .min_calls = 100});
+  std::atomic<int> short_circuited{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; ++i) {
+        auto r = breaker.call(i % 4 == 0 ? ok : fail);
+        if (!r.has_value() && r.error() == Db_error::unavailable)
+          short_circuited.fetch_add(1);
+      }
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+  EXPECT_EQ(breaker.state(), circuit_state::open);
+  EXPECT_GT(short_circuited.load(), 0);
+}
+
+TEST(circuit_breaker, failures_while_the_window_slides_are_kept) {
+  // Every call fails and none leaves the window, so the breaker opens exactly
+  // when the last failure is counted, unless a slide clears one.
+  constexpr int threads_count = 4;
+  constexpr int failures = 2000;
+  for (int round = 0; round < 20; ++round) {
+    std::atomic<std::int64_t> elapsed{0};
+    circuit_breaker<Db_error, Shared_clock> breaker(
+        Db_error::unavailable,
+        {.failure_rate = 1.0,
+         .min_calls = threads_count * failures,
+         .window = 8s,
+         .buckets = 8},
+        {&elapsed});
+    std::atomic<int> made{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < failures; ++i) {
+          static_cast<void>(breaker.call(fail));
+          made.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+    }
+    // Slides through seven of the eight buckets while the failures are made.
+    for (std::int64_t second = 1; second < 8; ++second) {
+      while (made.load(std::memory_order_relaxed) <
+             second * threads_count * failures / 8)
+        std::this_thread::yield();
+      elapsed.store(std::chrono::nanoseconds(std::chrono::seconds(second))
+                        .count(),
+                    std::memory_order_relaxed);
+    }
+    for (auto& t : threads)
+      t.join();
+    ASSERT_EQ(breaker.state(), circuit_state::open) << "round " << round;
+  }
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
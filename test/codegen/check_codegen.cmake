@@ -0,0 +1,102 @@
+# Compares the code generated for the probes in probes.cpp with a baseline.
+#
+# Usage:
+#   cmake -DOBJDUMP=<objdump> -DOBJECT=<probes.o> -DBASELINE=<file>
+#         [-DUPDATE=ON] -P check_codegen.cmake
+#
+# The baseline has one line per probe: name, instructions, branches and calls,
+# not counting padding. The check fails if a probe is missing or any count
+# grew. With UPDATE=ON the baseline is rewritten from the object instead.
+
+cmake_minimum_required(VERSION 3.23)
+
+foreach(var IN ITEMS OBJDUMP OBJECT BASELINE)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "${var} is not set")
+  endif()
+endforeach()
+
+execute_process(
+  COMMAND ${OBJDUMP} -d --no-show-raw-insn ${OBJECT}
+  OUTPUT_VARIABLE disassembly
+  RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${OBJDUMP} failed: ${result}")
+endif()
+
+string(REPLACE ";" "," disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(probes)
+set(probe)
+foreach(line IN LISTS lines)
+  if(line MATCHES "^[0-9a-f]+ <([A-Za-z0-9_.]+)>:$")
+    set(name ${CMAKE_MATCH_1})
+    set(probe)
+    if(name MATCHES "^probe_")
+      set(probe ${name})
+      list(APPEND probes ${probe})
+      set(${probe}_instructions 0)
+      set(${probe}_branches 0)
+      set(${probe}_calls 0)
+    endif()
+  elseif(probe AND line MATCHES "^ +[0-9a-f]+:\t([a-z0-9]+)")
+    set(mnemonic ${CMAKE_MATCH_1})
+    if(mnemonic MATCHES "^(nop|xchg|data16|cs)")
+      continue()
+    endif()
+    math(EXPR ${probe}_instructions "${${probe}_instructions} + 1")
+    if(mnemonic MATCHES "^j")
+      math(EXPR ${probe}_branches "${${probe}_branches} + 1")
+    elseif(mnemonic MATCHES "^call")
+      math(EXPR ${probe}_calls "${${probe}_calls} + 1")
+    endif()
+  endif()
+endforeach()
+
+if(NOT probes)
+  message(FATAL_ERROR "No probes found in ${OBJECT}")
+endif()
+
+if(UPDATE)
+  set(content "# probe instructions branches calls\n")
+  foreach(probe IN LISTS probes)
+    string(APPEND content "${probe} ${${probe}_instructions} "
+      "${${probe}_branches} ${${probe}_calls}\n")
+  endforeach()
+  file(WRITE ${BASELINE} "${content}")
+  message(STATUS "Wrote ${BASELINE}")
+  return()
+endif()
+
+file(STRINGS ${BASELINE} baseline REGEX "^probe_")
+set(failed FALSE)
+foreach(entry IN LISTS baseline)
+  string(REPLACE " " ";" fields "${entry}")
+  list(GET fields 0 probe)
+  list(GET fields 1 instructions)
+  list(GET fields 2 branches)
+  list(GET fields 3 calls)
+  if(NOT DEFINED ${probe}_instructions)
+    message(SEND_ERROR "${probe}: missing from ${OBJECT}")
+    set(failed TRUE)
+    continue()
+  endif()
+  set(actual "${${probe}_instructions} ${${probe}_branches} ${${probe}_calls}")
+  set(expected "${instructions} ${branches} ${calls}")
+  if(${probe}_instructions GREATER instructions OR
+     ${probe}_branches GREATER branches OR
+     ${probe}_calls GREATER calls)
+    message(SEND_ERROR "${probe}: got ${actual} (instructions branches "
+      "calls), baseline ${expected}")
+    set(failed TRUE)
+  elseif(NOT actual STREQUAL expected)
+    message(STATUS "${probe}: improved to ${actual} from ${expected}; "
+      "update the baseline")
+  endif()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "Generated code regressed; see ${BASELINE}")
+endif()
@@ -0,0 +1,82 @@
+#include "bc/expected.h"
+
+// Hot accessors whose generated code is checked against a recorded baseline
+// by check_codegen.cmake. The probes have C linkage so that objdump prints
+// plain names. Add a probe here and regenerate the baseline with
+// -DUPDATE=ON to cover a new path.
+
+// NOLINTBEGIN(*-avoid-magic-numbers, *-use-trailing-return-type)
+
+namespace {
+
+struct Point {
+  int x;
+  int y;
+};
+
+} // namespace
+
+using Int_int = bc::expected<int, int>;
+using Point_int = bc::expected<Point, int>;
+using Void_int = bc::expected<void, int>;
+
+extern "C" {
+
+bool probe_has_value(const Int_int& e) {
+  return e.has_value();
+}
+
+bool probe_operator_bool(const Int_int& e) {
+  return static_cast<bool>(e);
+}
+
+int probe_indirection(const Int_int& e) {
+  return *e;
+}
+
+int probe_member_access(const Point_int& e) {
+  return e->y;
+}
+
+int probe_error(const Int_int& e) {
+  return e.error();
+}
+
+int probe_value_or_zero(Int_int e) {
+  return e ? *e : 0;
+}
+
+int probe_value_or(const Int_int& e) {
+  return e.value_or(0);
+}
+
+int probe_error_or(const Int_int& e) {
+  return e.error_or(0);
+}
+
+bool probe_has_value_void(const Void_int& e) {
+  return e.has_value();
+}
+
+int probe_error_void(const Void_int& e) {
+  return e.error();
+}
+
+bool probe_equal(const Int_int& x, const Int_int& y) {
+  return x == y;
+}
+
+bool probe_equal_value(const Int_int& e, int v) {
+  return e == v;
+}
+
+void probe_copy(Int_int& x, const Int_int& y) {
+  x = y;
+}
+
+void probe_swap(Point_int& x, Point_int& y) {
+  x.swap(y);
+}
+}
+
+// NOLINTEND(*-avoid-magic-numbers, *-use-trailing-return-type)
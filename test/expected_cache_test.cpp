@@ -0,0 +1,231 @@
+#include "bc/expected_cache.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+using namespace std::chrono_literals;
+
+namespace {
+
+enum class Lookup_error { not_found = 1, unavailable };
+
+// A clock that only moves when the test advances it.
+struct Manual_clock {
+  using duration = std::chrono::nanoseconds;
+  using time_point = std::chrono::time_point<Manual_clock, duration>;
+
+  time_point now() const noexcept { return time_point(*elapsed); }
+
+  const duration* elapsed;
+};
+
+using manual_cache =
+    expected_cache<int, std::string, Lookup_error, std::hash<int>,
+                   std::equal_to<int>, Manual_clock>;
+
+expected<std::string, Lookup_error> lookup(int key) {
+  if (key < 0)
+    return unexpected(Lookup_error::not_found);
+  return std::to_string(key);
+}
+
+// Counts its copies.
+struct Copied {
+  explicit Copied(int* c) : copies(c) {}
+  Copied(const Copied& other) : copies(other.copies) { ++*copies; }
+  Copied(Copied&&) noexcept = default;
+  Copied& operator=(const Copied&) = delete;
+  Copied& operator=(Copied&&) = delete;
+  ~Copied() = default;
+
+  int* copies;
+};
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(expected_cache, values_and_errors) {
+  expected_cache<int, std::string, Lookup_error> cache;
+  EXPECT_FALSE(cache.find(1).has_value());
+  cache.insert(1, "one");
+  cache.insert(-1, unexpected(Lookup_error::not_found));
+  EXPECT_EQ(**cache.find(1), "one");
+  EXPECT_EQ(cache.find(-1)->error(), Lookup_error::not_found);
+  EXPECT_EQ(cache.size(), 2U);
+
+  cache.insert(1, unexpected(Lookup_error::unavailable));
+  EXPECT_EQ(cache.find(1)->error(), Lookup_error::unavailable);
+  EXPECT_EQ(cache.size(), 2U);
+  EXPECT_TRUE(cache.erase(1));
+  EXPECT_FALSE(cache.erase(1));
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0U);
+}
+
+TEST(expected_cache, separate_ttls) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_cache cache({.value_ttl = 10s, .error_ttl = 1s}, {&elapsed});
+  cache.insert(1, "one");
+  cache.insert(-1, unexpected(Lookup_error::not_found));
+  elapsed = 999ms;
+  EXPECT_TRUE(cache.find(-1).has_value());
+  elapsed = 1s;
+  EXPECT_FALSE(cache.find(-1).has_value());
+  EXPECT_TRUE(cache.find(1).has_value());
+  elapsed = 10s;
+  EXPECT_FALSE(cache.find(1).has_value());
+}
+
+TEST(expected_cache, zero_ttl_is_not_cached) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_cache cache({.error_ttl = 0s}, {&elapsed});
+  int calls = 0;
+  auto compute = [&] {
+    ++calls;
+    return lookup(-1);
+  };
+  EXPECT_FALSE(cache.get_or_compute(-1, compute).has_value());
+  EXPECT_FALSE(cache.get_or_compute(-1, compute).has_value());
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(cache.size(), 0U);
+}
+
+TEST(expected_cache, fifo_eviction) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_cache cache(
+      {.max_errors = 2, .error_eviction = cache_eviction::fifo, .shards = 1},
+      {&elapsed});
+  cache.insert(-1, unexpected(Lookup_error::not_found));
+  cache.insert(-2, unexpected(Lookup_error::not_found));
+  EXPECT_TRUE(cache.find(-1).has_value());
+  cache.insert(-3, unexpected(Lookup_error::not_found));
+  EXPECT_FALSE(cache.find(-1).has_value());
+  EXPECT_TRUE(cache.find(-2).has_value());
+  EXPECT_TRUE(cache.find(-3).has_value());
+  // Errors do not take the room of values.
+  cache.insert(1, "one");
+  EXPECT_EQ(cache.size(), 3U);
+}
+
+TEST(expected_cache, second_chance_eviction) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_cache cache({.max_values = 2,
+                      .value_eviction = cache_eviction::second_chance,
+                      .shards = 1},
+                     {&elapsed});
+  cache.insert(1, "one");
+  cache.insert(2, "two");
+  // Read, so the newer entry is evicted instead.
+  EXPECT_TRUE(cache.find(1).has_value());
+  cache.insert(3, "three");
+  EXPECT_TRUE(cache.find(1).has_value());
+  EXPECT_FALSE(cache.find(2).has_value());
+  EXPECT_TRUE(cache.find(3).has_value());
+}
+
+TEST(expected_cache, expired_entries_are_evicted_first) {
+  std::chrono::nanoseconds elapsed{0};
+  manual_cache cache({.max_values = 2, .shards = 1}, {&elapsed});
+  cache.insert(1, "one");
+  cache.insert(-1, unexpected(Lookup_error::not_found));
+  elapsed = 2s;
+  cache.insert(-2, unexpected(Lookup_error::not_found));
+  EXPECT_EQ(cache.size(), 2U);
+  EXPECT_TRUE(cache.find(1).has_value());
+}
+
+TEST(expected_cache, get_or_compute_caches) {
+  expected_cache<int, std::string, Lookup_error> cache;
+  int calls = 0;
+  auto compute = [&](int key) {
+    return [&, key] {
+      ++calls;
+      return lookup(key);
+    };
+  };
+  EXPECT_EQ(*cache.get_or_compute(4, compute(4)), "4");
+  EXPECT_EQ(*cache.get_or_compute(4, compute(4)), "4");
+  EXPECT_FALSE(cache.get_or_compute(-4, compute(-4)).has_value());
+  EXPECT_FALSE(cache.get_or_compute(-4, compute(-4)).has_value());
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(expected_cache, miss_copies_the_result_once) {
+  expected_cache<int, Copied, Lookup_error> cache;
+  int copies = 0;
+  auto r = cache.get_or_compute(1, [&] {
+    return expected<Copied, Lookup_error>(std::in_place, &copies);
+  });
+  ASSERT_TRUE(r.has_value());
+  // Into the cache; the caller gets the computed result.
+  EXPECT_EQ(copies, 1);
+}
+
+TEST(expected_cache, single_flight) {
+  expected_cache<int, std::string, Lookup_error> cache;
+  std::atomic<int> calls{0};
+  std::atomic<bool> release{false};
+  auto compute = [&] {
+    calls.fetch_add(1);
+    while (!release.load())
+      std::this_thread::yield();
+    return lookup(7);
+  };
+
+  std::vector<std::thread> threads;
+  std::atomic<int> correct{0};
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      if (cache.get_or_compute(7, compute) == "7")
+        correct.fetch_add(1);
+    });
+  }
+  while (calls.load() == 0)
+    std::this_thread::yield();
+  std::this_thread::sleep_for(10ms);
+  release.store(true);
+  for (auto& t : threads)
+    t.join();
+  EXPECT_EQ(calls.load(), 1);
+  EXPECT_EQ(correct.load(), 4);
+}
+
+TEST(expected_cache, throwing_computation_is_retried) {
+  expected_cache<int, std::string, Lookup_error> cache;
+  std::atomic<bool> started{false};
+  std::atomic<bool> waiting{false};
+  std::thread leader([&] {
+    EXPECT_THROW(cache.get_or_compute(
+                     5,
+                     [&]() -> expected<std::string, Lookup_error> {
+                       started.store(true);
+                       while (!waiting.load())
+                         std::this_thread::yield();
+                       std::this_thread::sleep_for(10ms);
+                       throw std::runtime_error("backend");
+                     }),
+                 std::runtime_error);
+  });
+  while (!started.load())
+    std::this_thread::yield();
+  // Waits for the leader, then computes; it may also start after the leader
+  // threw, and compute directly.
+  std::thread waiter([&] {
+    waiting.store(true);
+    EXPECT_EQ(*cache.get_or_compute(5, [] { return lookup(5); }), "5");
+  });
+  leader.join();
+  waiter.join();
+  EXPECT_EQ(**cache.find(5), "5");
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
@@ -0,0 +1,145 @@
+#include "bc/expected_channel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Io_error { eof = 1, reset };
+
+// Counts live instances, to check that values left in a channel are
+// destroyed.
+struct Counted {
+  explicit Counted(int* c) : count(c) { ++*count; }
+  Counted(Counted&& other) noexcept : count(other.count) { ++*count; }
+  Counted& operator=(Counted&&) = delete;
+  ~Counted() { --*count; }
+
+  int* count;
+};
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(expected_channel, capacity) {
+  EXPECT_EQ((expected_channel<int, Io_error>(0).capacity()), 1U);
+  EXPECT_EQ((expected_channel<int, Io_error>(5).capacity()), 8U);
+  EXPECT_EQ((expected_channel<int, Io_error>(8).capacity()), 8U);
+}
+
+TEST(expected_channel, slots) {
+  EXPECT_EQ((sizeof(detail::channel_slot<int, true>)), 64U);
+  EXPECT_EQ((sizeof(detail::channel_slot<std::int64_t, false>)), 16U);
+}
+
+TEST(expected_channel, send_and_receive_in_order) {
+  expected_channel<std::string, Io_error> c(4);
+  EXPECT_FALSE(c.try_receive().has_value());
+  EXPECT_TRUE(c.try_send("a"));
+  EXPECT_TRUE(c.try_send(std::string("b")));
+  EXPECT_TRUE(c.send(3, 'c'));
+  auto v = c.try_receive();
+  ASSERT_TRUE(v.has_value());
+  EXPECT_EQ(**v, "a");
+  EXPECT_EQ(*c.receive(), "b");
+  EXPECT_EQ(*c.receive(), "ccc");
+  EXPECT_FALSE(c.try_receive().has_value());
+}
+
+TEST(expected_channel, full) {
+  expected_channel<int, Io_error> c(2);
+  EXPECT_TRUE(c.try_send(1));
+  EXPECT_TRUE(c.try_send(2));
+  EXPECT_FALSE(c.try_send(3));
+  EXPECT_EQ(*c.receive(), 1);
+  EXPECT_TRUE(c.try_send(3));
+  EXPECT_EQ(*c.receive(), 2);
+  EXPECT_EQ(*c.receive(), 3);
+}
+
+TEST(expected_channel, close_with_error) {
+  expected_channel<int, Io_error> c(4);
+  EXPECT_TRUE(c.try_send(1));
+  EXPECT_TRUE(c.try_send(2));
+  EXPECT_FALSE(c.closed());
+  EXPECT_TRUE(c.close(Io_error::reset));
+  EXPECT_TRUE(c.closed());
+  EXPECT_FALSE(c.close(Io_error::eof));
+  EXPECT_FALSE(c.try_send(3));
+  EXPECT_FALSE(c.send(3));
+
+  // The values sent before the error, then the error.
+  EXPECT_EQ(*c.receive(), 1);
+  EXPECT_EQ(*c.receive(), 2);
+  for (int i = 0; i < 2; ++i) {
+    auto v = c.receive();
+    ASSERT_FALSE(v.has_value());
+    EXPECT_EQ(v.error(), Io_error::reset);
+  }
+}
+
+TEST(expected_channel, values_destroyed) {
+  int count = 0;
+  {
+    expected_channel<Counted, Io_error, false> c(4);
+    c.try_send(&count);
+    c.try_send(&count);
+    c.try_send(&count);
+    { auto v = c.receive(); }
+    EXPECT_EQ(count, 2);
+  }
+  EXPECT_EQ(count, 0);
+}
+
+TEST(expected_channel, producers_and_consumers) {
+  constexpr int producers = 4;
+  constexpr int consumers = 4;
+  constexpr std::int64_t per_producer = 20000;
+  expected_channel<std::int64_t, Io_error> c(64);
+
+  std::atomic<int> producing{producers};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (std::int64_t i = 0; i < per_producer; ++i)
+        c.send(p * per_producer + i);
+      if (producing.fetch_sub(1) == 1)
+        c.close(Io_error::eof);
+    });
+  }
+  std::vector<std::int64_t> sums(consumers);
+  std::vector<int> errors(consumers);
+  for (int k = 0; k < consumers; ++k) {
+    threads.emplace_back([&, k] {
+      for (;;) {
+        auto v = c.receive();
+        if (!v.has_value()) {
+          errors[static_cast<std::size_t>(k)] += v.error() == Io_error::eof;
+          break;
+        }
+        sums[static_cast<std::size_t>(k)] += *v;
+      }
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+
+  std::int64_t sum = 0;
+  for (std::int64_t s : sums)
+    sum += s;
+  const std::int64_t n = producers * per_producer;
+  EXPECT_EQ(sum, n * (n - 1) / 2);
+  for (int e : errors)
+    EXPECT_EQ(e, 1);
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
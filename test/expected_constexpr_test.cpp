@@ -219,6 +219,81 @@ TEST(expected_constexpr, value_or) {
 
 namespace {
 
+template <class Tag>
+constexpr int value_or_else_function_const_l_ref(int x) {
+  const expected<Val, Err> e(Tag(), x);
+  Val val = e.value_or_else([x] { return Val(x + x); });
+  return val.x;
+}
+
+template <class Tag>
+constexpr int value_or_else_function_non_const_r_ref(int x) {
+  expected<Val, Err> e(Tag(), x);
+  Val val = std::move(e).value_or_else([x] { return Val(x + x); });
+  return val.x;
+}
+
+} // namespace
+
+TEST(expected_constexpr, value_or_else) {
+  {
+    constexpr int x = value_or_else_function_const_l_ref<std::in_place_t>(1);
+    ASSERT_EQ(x, 1);
+  }
+  {
+    constexpr int x = value_or_else_function_const_l_ref<unexpect_t>(2);
+    ASSERT_EQ(x, 2 + 2);
+  }
+  {
+    constexpr int x =
+        value_or_else_function_non_const_r_ref<std::in_place_t>(3);
+    ASSERT_EQ(x, 3 + 101);
+  }
+  {
+    constexpr int x = value_or_else_function_non_const_r_ref<unexpect_t>(4);
+    ASSERT_EQ(x, 4 + 4);
+  }
+}
+
+namespace {
+
+template <class Tag>
+constexpr int error_or_function_const_l_ref(int x) {
+  const expected<Val, Err> e(Tag(), x);
+  Err err = e.error_or(Err(x + x));
+  return err.x;
+}
+
+template <class Tag>
+constexpr int error_or_function_non_const_r_ref(int x) {
+  expected<Val, Err> e(Tag(), x);
+  Err err = std::move(e).error_or(Err(x + x));
+  return err.x;
+}
+
+} // namespace
+
+TEST(expected_constexpr, error_or) {
+  {
+    constexpr int x = error_or_function_const_l_ref<std::in_place_t>(1);
+    ASSERT_EQ(x, 1 + 1 + 101);
+  }
+  {
+    constexpr int x = error_or_function_const_l_ref<unexpect_t>(2);
+    ASSERT_EQ(x, 2);
+  }
+  {
+    constexpr int x = error_or_function_non_const_r_ref<std::in_place_t>(3);
+    ASSERT_EQ(x, 3 + 3 + 101);
+  }
+  {
+    constexpr int x = error_or_function_non_const_r_ref<unexpect_t>(4);
+    ASSERT_EQ(x, 4 + 101);
+  }
+}
+
+namespace {
+
 constexpr bool has_value_function() {
   expected<Val, Err> e(std::in_place);
   bool b = e.has_value();
@@ -541,6 +616,226 @@ TEST(expected_constexpr, in_place_constructor) {
 
 namespace {
 
+template <class Tag, class Other_tag>
+constexpr int copy_assignment(int x, int y) {
+  // Assigning between the two states takes the rollback path at run time,
+  // which relocates Val_trivial with memcpy.
+  expected<Val_trivial, Err_throw> e(Tag(), x);
+  const expected<Val_trivial, Err_throw> other(Other_tag(), y);
+  e = other;
+  return std::is_same_v<Other_tag, std::in_place_t> ? e->x : e.error().x;
+}
+
+template <class Tag, class Other_tag>
+constexpr int move_assignment(int x, int y) {
+  expected<Val, Err> e(Tag(), x);
+  expected<Val, Err> other(Other_tag(), y);
+  e = std::move(other);
+  return std::is_same_v<Other_tag, std::in_place_t> ? e->x : e.error().x;
+}
+
+} // namespace
+
+TEST(expected_constexpr, copy_assignment) {
+  static_assert(!std::is_nothrow_copy_constructible_v<Err_throw> &&
+                !std::is_nothrow_move_constructible_v<Err_throw>);
+  static_assert(is_trivially_relocatable_v<Val_trivial>);
+  {
+    constexpr int x = copy_assignment<std::in_place_t, std::in_place_t>(1, 2);
+    ASSERT_EQ(x, 2);
+  }
+  {
+    constexpr int x = copy_assignment<std::in_place_t, unexpect_t>(3, 4);
+    ASSERT_EQ(x, 4);
+  }
+  {
+    constexpr int x = copy_assignment<unexpect_t, std::in_place_t>(5, 6);
+    ASSERT_EQ(x, 6);
+  }
+  {
+    constexpr int x = copy_assignment<unexpect_t, unexpect_t>(7, 8);
+    ASSERT_EQ(x, 8);
+  }
+}
+
+TEST(expected_constexpr, move_assignment) {
+  {
+    constexpr int x = move_assignment<std::in_place_t, std::in_place_t>(1, 2);
+    ASSERT_EQ(x, 2 + Val::move_assignment_offset);
+  }
+  {
+    constexpr int x = move_assignment<std::in_place_t, unexpect_t>(3, 4);
+    ASSERT_EQ(x, 4 + Err::move_constructor_offset);
+  }
+  {
+    constexpr int x = move_assignment<unexpect_t, std::in_place_t>(5, 6);
+    ASSERT_EQ(x, 6 + Val::move_constructor_offset);
+  }
+  {
+    constexpr int x = move_assignment<unexpect_t, unexpect_t>(7, 8);
+    ASSERT_EQ(x, 8 + Err::move_assignment_offset);
+  }
+}
+
+namespace {
+
+template <class Tag>
+constexpr int value_assignment(int x, int y) {
+  expected<Val, Err> e(Tag(), x);
+  e = Arg(y);
+  return e->x;
+}
+
+template <class Tag>
+constexpr int unexpected_assignment(int x, int y) {
+  expected<Val, Err> e(Tag(), x);
+  unexpected<Err> other(y);
+  e = other;
+  return e.error().x;
+}
+
+} // namespace
+
+TEST(expected_constexpr, value_assignment) {
+  {
+    constexpr int x = value_assignment<std::in_place_t>(1, 2);
+    ASSERT_EQ(x, 2 + Arg::move_assignment_offset);
+  }
+  {
+    constexpr int x = value_assignment<unexpect_t>(3, 4);
+    ASSERT_EQ(x, 4 + Arg::move_constructor_offset);
+  }
+}
+
+TEST(expected_constexpr, unexpected_assignment) {
+  {
+    constexpr int x = unexpected_assignment<std::in_place_t>(1, 2);
+    ASSERT_EQ(x, 2);
+  }
+  {
+    constexpr int x = unexpected_assignment<unexpect_t>(3, 4);
+    ASSERT_EQ(x, 4);
+  }
+}
+
+namespace {
+
+template <class Tag>
+constexpr int emplace(int x, int y) {
+  expected<Val, Err> e(Tag(), x);
+  Val& val = e.emplace(Arg(y), 1);
+  return val.x;
+}
+
+template <class Tag>
+constexpr int emplace_initializer_list(int x, int y) {
+  expected<Val, Err> e(Tag(), x);
+  Val& val = e.emplace({1}, Arg(y), 1);
+  return val.x;
+}
+
+} // namespace
+
+TEST(expected_constexpr, emplace) {
+  {
+    constexpr int x = emplace<std::in_place_t>(1, 2);
+    ASSERT_EQ(x, 2 + Arg::move_constructor_offset + 1 +
+                     Val::move_assignment_offset);
+  }
+  {
+    constexpr int x = emplace<unexpect_t>(3, 4);
+    ASSERT_EQ(x, 4 + Arg::move_constructor_offset + 1);
+  }
+  {
+    constexpr int x = emplace_initializer_list<std::in_place_t>(5, 6);
+    ASSERT_EQ(x, 6 + Arg::move_constructor_offset + 1 + 1 +
+                     Val::move_assignment_offset);
+  }
+  {
+    constexpr int x = emplace_initializer_list<unexpect_t>(7, 8);
+    ASSERT_EQ(x, 8 + Arg::move_constructor_offset + 1 + 1);
+  }
+}
+
+namespace {
+
+template <class Tag, class Other_tag>
+constexpr int swap(int x, int y) {
+  // Val_trivial and Err_trivial are trivially relocatable, so swapping
+  // between the two states copies bytes at run time.
+  expected<Val_trivial, Err_trivial> e(Tag(), x);
+  expected<Val_trivial, Err_trivial> other(Other_tag(), y);
+  e.swap(other);
+  int e_x = std::is_same_v<Other_tag, std::in_place_t> ? e->x : e.error().x;
+  int other_x =
+      std::is_same_v<Tag, std::in_place_t> ? other->x : other.error().x;
+  return e_x * 10 + other_x;
+}
+
+} // namespace
+
+TEST(expected_constexpr, swap) {
+  static_assert(is_trivially_relocatable_v<Val_trivial> &&
+                is_trivially_relocatable_v<Err_trivial>);
+  {
+    constexpr int x = swap<std::in_place_t, std::in_place_t>(1, 2);
+    ASSERT_EQ(x, 21);
+  }
+  {
+    constexpr int x = swap<std::in_place_t, unexpect_t>(3, 4);
+    ASSERT_EQ(x, 43);
+  }
+  {
+    constexpr int x = swap<unexpect_t, std::in_place_t>(5, 6);
+    ASSERT_EQ(x, 65);
+  }
+  {
+    constexpr int x = swap<unexpect_t, unexpect_t>(7, 8);
+    ASSERT_EQ(x, 87);
+  }
+}
+
+namespace {
+
+template <class Tag>
+constexpr int destructor() {
+  int destroyed = 0;
+  {
+    expected<Val_destructor, Err_destructor> e(Tag(), 1, &destroyed);
+  }
+  return destroyed;
+}
+
+constexpr int destructor_after_assignment() {
+  int destroyed = 0;
+  {
+    expected<Val_destructor, Err_destructor> e(std::in_place, 1, &destroyed);
+    const expected<Val_destructor, Err_destructor> other(unexpect, 2,
+                                                         &destroyed);
+    e = other; // Destroys the value.
+  }
+  return destroyed;
+}
+
+} // namespace
+
+TEST(expected_constexpr, destructor) {
+  {
+    constexpr int x = destructor<std::in_place_t>();
+    ASSERT_EQ(x, 1);
+  }
+  {
+    constexpr int x = destructor<unexpect_t>();
+    ASSERT_EQ(x, 1);
+  }
+  {
+    constexpr int x = destructor_after_assignment();
+    ASSERT_EQ(x, 3);
+  }
+}
+
+namespace {
+
 template <class Compare>
 constexpr bool equality_operators(int x, int y) {
   expected<Val, Err> e1(std::in_place, x);
@@ -0,0 +1,215 @@
+#include "bc/expected_future.h"
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+struct Task_error {
+  Task_error() = default;
+  explicit Task_error(int c) : code(c) {}
+  // NOLINTNEXTLINE(*-explicit-constructor): Broken promise
+  Task_error(promise_errc e) : code(-static_cast<int>(e)) {}
+
+  int code = 0;
+};
+
+enum class Io_error { failed = 1, broken };
+
+} // namespace
+
+template <>
+struct bc::broken_promise_error<Io_error> {
+  static Io_error error() { return Io_error::broken; }
+};
+
+namespace {
+
+// Counts live instances, to check that results are destroyed.
+struct Counted {
+  explicit Counted(int* c) : count(c) { ++*count; }
+  Counted(const Counted& other) : count(other.count) { ++*count; }
+  Counted& operator=(const Counted&) = delete;
+  ~Counted() { --*count; }
+
+  int* count;
+};
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(expected_future, set_value_then_get) {
+  expected_promise<int, Task_error> p;
+  expected_future<int, Task_error> f = p.get_future();
+  EXPECT_TRUE(f.valid());
+  EXPECT_FALSE(f.is_ready());
+  p.set_value(42);
+  EXPECT_TRUE(f.is_ready());
+  expected<int, Task_error> r = f.get();
+  EXPECT_FALSE(f.valid());
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(*r, 42);
+}
+
+TEST(expected_future, set_error) {
+  expected_promise<std::string, Task_error> p;
+  auto f = p.get_future();
+  p.set_error(7);
+  auto r = f.get();
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error().code, 7);
+}
+
+TEST(expected_future, set_result) {
+  expected_promise<std::string, Task_error> p;
+  auto f = p.get_future();
+  p.set_result(expected<std::string, Task_error>("done"));
+  auto r = f.get();
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(*r, "done");
+}
+
+TEST(expected_future, void_value) {
+  expected_promise<void, Task_error> p;
+  auto f = p.get_future();
+  p.set_value();
+  EXPECT_TRUE(f.get().has_value());
+}
+
+TEST(expected_future, broken_promise) {
+  expected_future<int, Task_error> f;
+  EXPECT_FALSE(f.valid());
+  {
+    expected_promise<int, Task_error> p;
+    f = p.get_future();
+  }
+  auto r = f.get();
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error().code, -static_cast<int>(promise_errc::broken_promise));
+}
+
+TEST(expected_future, broken_promise_customized) {
+  static_assert(detail::has_broken_promise_error<Task_error>);
+  static_assert(detail::has_broken_promise_error<Io_error>);
+  static_assert(!detail::has_broken_promise_error<int>);
+
+  expected_future<int, Io_error> f;
+  {
+    expected_promise<int, Io_error> p;
+    f = p.get_future();
+  }
+  EXPECT_EQ(f.get().error(), Io_error::broken);
+}
+
+TEST(expected_future, move) {
+  expected_promise<int, Task_error> p1;
+  auto f1 = p1.get_future();
+  expected_promise<int, Task_error> p2 = std::move(p1);
+  expected_future<int, Task_error> f2;
+  f2 = std::move(f1);
+  EXPECT_FALSE(f1.valid()); // NOLINT(*-use-after-move)
+  p2.set_value(3);
+  EXPECT_EQ(*f2.get(), 3);
+}
+
+TEST(expected_future, result_destroyed) {
+  int count = 0;
+  {
+    // The future is destroyed first.
+    expected_promise<Counted, Task_error> p;
+    { auto f = p.get_future(); }
+    p.set_value(&count);
+    EXPECT_EQ(count, 0);
+  }
+  {
+    // The promise sets the result and is destroyed first.
+    expected_promise<Counted, Task_error> p;
+    auto f = p.get_future();
+    p.set_value(&count);
+    EXPECT_EQ(count, 1);
+    { auto r = f.get(); }
+    EXPECT_EQ(count, 0);
+  }
+  {
+    // The result is never taken.
+    expected_promise<Counted, Task_error> p;
+    auto f = p.get_future();
+    p.set_value(&count);
+  }
+  EXPECT_EQ(count, 0);
+  {
+    // No future was retrieved: the result is destroyed when it is set.
+    expected_promise<Counted, Task_error> p;
+    p.set_value(&count);
+    EXPECT_EQ(count, 0);
+  }
+}
+
+TEST(expected_future, future_not_retrieved) {
+  expected_promise<int, Task_error> p;
+}
+
+TEST(expected_future, shared_states_are_reused) {
+  using pool = detail::future_state_pool<double, Task_error>;
+  auto* state = pool::acquire();
+  pool::release(state);
+  // A state released by this thread is the next one it acquires, so a task
+  // loop does not allocate.
+  for (int i = 0; i < 3; ++i) {
+    expected_promise<double, Task_error> p;
+    auto f = p.get_future();
+    p.set_value(2.0);
+    EXPECT_EQ(*f.get(), 2.0);
+  }
+  auto* reused = pool::acquire();
+  EXPECT_EQ(reused, state);
+  pool::release(reused);
+}
+
+TEST(expected_future, wait_across_threads) {
+  constexpr int tasks = 2000;
+  std::vector<expected_promise<int, Task_error>> promises(tasks);
+  std::vector<expected_future<int, Task_error>> futures;
+  futures.reserve(tasks);
+  for (auto& p : promises)
+    futures.push_back(p.get_future());
+
+  std::thread producer([&] {
+    for (int i = 0; i < tasks; ++i) {
+      if (i % 3 == 0)
+        promises[static_cast<std::size_t>(i)].set_error(i);
+      else
+        promises[static_cast<std::size_t>(i)].set_value(i);
+    }
+  });
+  for (int i = 0; i < tasks; ++i) {
+    auto r = futures[static_cast<std::size_t>(i)].get();
+    EXPECT_EQ(r.has_value(), i % 3 != 0);
+    EXPECT_EQ(r.has_value() ? *r : r.error().code, i);
+  }
+  producer.join();
+}
+
+TEST(expected_future, released_on_other_thread) {
+  // Promises created on one thread and completed on others return their
+  // states to the pool of the thread that drops the last reference.
+  constexpr int rounds = 200;
+  for (int i = 0; i < rounds; ++i) {
+    expected_promise<std::string, Task_error> p;
+    auto f = p.get_future();
+    std::thread worker(
+        [p = std::move(p)]() mutable { p.set_value("result"); });
+    EXPECT_EQ(*f.get(), "result");
+    worker.join();
+  }
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
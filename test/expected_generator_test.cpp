@@ -0,0 +1,131 @@
+#include "bc/expected_generator.h"
+
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Parse_error { malformed = 1 };
+
+using record_generator = expected_generator<int, Parse_error>;
+
+static_assert(std::input_iterator<record_generator::iterator>);
+static_assert(std::ranges::input_range<record_generator>);
+static_assert(std::ranges::view<record_generator>);
+
+expected<int, Parse_error> parse_record(const std::string& line) {
+  if (line.empty() || line.find_first_not_of("0123456789") != line.npos)
+    return unexpected(Parse_error::malformed);
+  return std::stoi(line);
+}
+
+record_generator parse(std::vector<std::string> lines) {
+  for (const auto& line : lines)
+    co_yield parse_record(line);
+}
+
+// Counts the copies of the yielded expected.
+struct Counted {
+  Counted() = default;
+  Counted(const Counted& other) : copies(other.copies + 1) {}
+  Counted(Counted&&) = default;
+  Counted& operator=(const Counted&) = delete;
+  Counted& operator=(Counted&&) = default;
+  ~Counted() = default;
+
+  int copies = 0;
+};
+
+expected_generator<Counted, Parse_error> counted() {
+  expected<Counted, Parse_error> e;
+  co_yield e;
+  co_yield expected<Counted, Parse_error>();
+  const expected<Counted, Parse_error> c;
+  co_yield c;
+}
+
+expected_generator<std::string, Parse_error> words() {
+  expected<std::string, Parse_error> e("first");
+  co_yield e;
+  // The caller moved the value out.
+  co_yield expected<std::string, Parse_error>(e->empty() ? "moved" : "kept");
+}
+
+expected_generator<int, Parse_error> throwing() {
+  co_yield 1;
+  throw std::runtime_error("read failed");
+}
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(expected_generator, values_and_errors) {
+  std::vector<int> values;
+  int errors = 0;
+  for (auto& r : parse({"1", "x", "3"})) {
+    if (r.has_value())
+      values.push_back(*r);
+    else
+      ++errors;
+  }
+  EXPECT_EQ(values, (std::vector<int>{1, 3}));
+  EXPECT_EQ(errors, 1);
+}
+
+TEST(expected_generator, empty) {
+  auto g = parse({});
+  EXPECT_EQ(g.begin(), g.end());
+}
+
+TEST(expected_generator, stop_on_error) {
+  std::vector<expected<int, Parse_error>> seen;
+  for (auto& r : parse({"1", "", "3"}).stop_on_error())
+    seen.push_back(r);
+  ASSERT_EQ(seen.size(), 2U);
+  EXPECT_EQ(*seen[0], 1);
+  EXPECT_EQ(seen[1].error(), Parse_error::malformed);
+}
+
+TEST(expected_generator, yields_by_reference) {
+  std::vector<int> copies;
+  for (auto& r : counted())
+    copies.push_back(r->copies);
+  // Only the const lvalue is copied.
+  EXPECT_EQ(copies, (std::vector<int>{0, 0, 1}));
+}
+
+TEST(expected_generator, move_value_out) {
+  std::vector<std::string> out;
+  for (auto& r : words())
+    out.push_back(std::move(*r));
+  EXPECT_EQ(out, (std::vector<std::string>{"first", "moved"}));
+}
+
+TEST(expected_generator, views) {
+  auto ok = [](const auto& r) { return r.has_value(); };
+  auto doubled = parse({"1", "x", "2", "3", "4"}) | std::views::filter(ok) |
+                 std::views::transform([](const auto& r) { return *r * 2; }) |
+                 std::views::take(2);
+  std::vector<int> out;
+  for (int x : doubled)
+    out.push_back(x);
+  EXPECT_EQ(out, (std::vector<int>{2, 4}));
+}
+
+TEST(expected_generator, exception_propagates) {
+  auto g = throwing();
+  auto it = g.begin();
+  EXPECT_EQ(**it, 1);
+  EXPECT_THROW(++it, std::runtime_error);
+  EXPECT_EQ(it, g.end());
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
@@ -0,0 +1,227 @@
+#include "bc/expected_parse.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Color { red, green, blue };
+
+constexpr std::array<enum_name<Color>, 3> color_names = {{
+    {"red", Color::red},
+    {"green", Color::green},
+    {"blue", Color::blue},
+}};
+
+constexpr parse_error error(parse_errc code, std::size_t position = 0) {
+  return parse_error{code, position};
+}
+
+// Parses at compile time and at run time, and checks that both agree.
+template <class Int>
+constexpr expected<Int, parse_error> int_both(std::string_view s,
+                                              int base = 10) {
+  auto result = parse_int<Int>(s, base);
+  if (!std::is_constant_evaluated() && result != parse_int<Int>(s, base))
+    return unexpected(error(parse_errc::invalid_argument));
+  return result;
+}
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(expected_parse, parse_int) {
+  static_assert(parse_int<int>("0") == 0);
+  static_assert(parse_int<int>("123") == 123);
+  static_assert(parse_int<int>("-123") == -123);
+  static_assert(parse_int<int>("007") == 7);
+  static_assert(parse_int<std::int8_t>("127") == 127);
+  static_assert(parse_int<std::int8_t>("-128") == -128);
+  static_assert(parse_int<std::uint8_t>("255") == 255);
+  static_assert(parse_int<std::int64_t>("-9223372036854775808") ==
+                std::numeric_limits<std::int64_t>::min());
+  static_assert(parse_int<std::uint64_t>("18446744073709551615") ==
+                std::numeric_limits<std::uint64_t>::max());
+  static_assert(parse_int<int>("ff", 16) == 255);
+  static_assert(parse_int<int>("FF", 16) == 255);
+  static_assert(parse_int<int>("-101", 2) == -5);
+  static_assert(parse_int<int>("zz", 36) == 35 * 36 + 35);
+
+  static_assert(parse_int<int>("").error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_int<int>("-").error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_int<int>("+1").error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_int<int>(" 1").error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_int<unsigned>("-1").error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_int<int>("2", 2).error() ==
+                error(parse_errc::invalid_argument));
+
+  static_assert(parse_int<std::int8_t>("128").error() ==
+                error(parse_errc::result_out_of_range));
+  static_assert(parse_int<std::int8_t>("-129").error() ==
+                error(parse_errc::result_out_of_range));
+  static_assert(parse_int<std::uint8_t>("256").error() ==
+                error(parse_errc::result_out_of_range));
+  static_assert(parse_int<std::uint64_t>("18446744073709551616").error() ==
+                error(parse_errc::result_out_of_range));
+
+  static_assert(parse_int<int>("12a").error() ==
+                error(parse_errc::trailing_characters, 2));
+  static_assert(parse_int<int>("1 ").error() ==
+                error(parse_errc::trailing_characters, 1));
+
+  ASSERT_EQ(int_both<int>("-123"), -123);
+  ASSERT_EQ(int_both<int>("ff", 16), 255);
+  ASSERT_EQ(int_both<std::int8_t>("128").error(),
+            error(parse_errc::result_out_of_range));
+  ASSERT_EQ(int_both<int>("12a").error(),
+            error(parse_errc::trailing_characters, 2));
+}
+
+TEST(expected_parse, parse_float) {
+  static_assert(parse_float<double>("0") == 0.0);
+  static_assert(parse_float<double>("1.5") == 1.5);
+  static_assert(parse_float<double>("-1.5") == -1.5);
+  static_assert(parse_float<double>(".5") == 0.5);
+  static_assert(parse_float<double>("5.") == 5.0);
+  static_assert(parse_float<double>("0.1") == 0.1);
+  static_assert(parse_float<double>("1e3") == 1000.0);
+  static_assert(parse_float<double>("1E+3") == 1000.0);
+  static_assert(parse_float<double>("2.5e-3") == 0.0025);
+  static_assert(parse_float<double>("123456789012345e-10") ==
+                123456789012345e-10);
+  static_assert(parse_float<double>("1e100") == 1e100);
+  static_assert(parse_float<double>("1.7976931348623157e308") ==
+                std::numeric_limits<double>::max());
+  static_assert(parse_float<float>("0.1") == 0.1F);
+  static_assert(parse_float<float>("3.4028234e38") ==
+                std::numeric_limits<float>::max());
+  static_assert(parse_float<long double>("0.1") == 0.1L);
+  static_assert(parse_float<double>("inf") ==
+                std::numeric_limits<double>::infinity());
+  static_assert(parse_float<double>("-Infinity") ==
+                -std::numeric_limits<double>::infinity());
+  static_assert(parse_float<double>("nan").has_value());
+
+  static_assert(parse_float<double>("").error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_float<double>(".").error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_float<double>("e5").error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_float<double>("1e400").error() ==
+                error(parse_errc::result_out_of_range));
+  static_assert(parse_float<double>("1e-400").error() ==
+                error(parse_errc::result_out_of_range));
+  static_assert(parse_float<float>("1e39").error() ==
+                error(parse_errc::result_out_of_range));
+  static_assert(parse_float<double>("1.5x").error() ==
+                error(parse_errc::trailing_characters, 3));
+  static_assert(parse_float<double>("infx").error() ==
+                error(parse_errc::trailing_characters, 3));
+
+  // A missing exponent is not part of the number.
+  static_assert(parse_float<double>("1e").error() ==
+                error(parse_errc::trailing_characters, 1));
+  static_assert(parse_float<double>("1e+").error() ==
+                error(parse_errc::trailing_characters, 1));
+
+  ASSERT_EQ(parse_float<double>("1.5"), 1.5);
+  ASSERT_EQ(parse_float<double>("0.1"), 0.1);
+  ASSERT_EQ(parse_float<double>("1e100"), 1e100);
+  ASSERT_EQ(parse_float<float>("0.1"), 0.1F);
+  ASSERT_EQ(parse_float<double>("-inf"),
+            -std::numeric_limits<double>::infinity());
+  ASSERT_TRUE(std::isnan(*parse_float<double>("nan")));
+  ASSERT_EQ(parse_float<double>(".").error(),
+            error(parse_errc::invalid_argument));
+  ASSERT_EQ(parse_float<double>("1e400").error(),
+            error(parse_errc::result_out_of_range));
+  ASSERT_EQ(parse_float<double>("1.5x").error(),
+            error(parse_errc::trailing_characters, 3));
+  ASSERT_EQ(parse_float<double>("1e").error(),
+            error(parse_errc::trailing_characters, 1));
+}
+
+TEST(expected_parse, parse_enum) {
+  static_assert(parse_enum<Color>("red", color_names) == Color::red);
+  static_assert(parse_enum<Color>("blue", color_names) == Color::blue);
+  static_assert(parse_enum<Color>("Red", color_names).error() ==
+                error(parse_errc::invalid_argument));
+  static_assert(parse_enum<Color>("", color_names).error() ==
+                error(parse_errc::invalid_argument));
+
+  ASSERT_EQ(parse_enum<Color>("green", color_names), Color::green);
+  ASSERT_FALSE(parse_enum<Color>("purple", color_names).has_value());
+}
+
+TEST(expected_parse, split_bounded) {
+  {
+    constexpr auto r = split_bounded<3>("a,b,c", ',');
+    static_assert(r.has_value());
+    static_assert(r->size == 3);
+    static_assert((*r)[0] == "a" && (*r)[1] == "b" && (*r)[2] == "c");
+  }
+  {
+    constexpr auto r = split_bounded<3>("a,,b", ',');
+    static_assert(r->size == 3 && (*r)[1].empty());
+  }
+  {
+    constexpr auto r = split_bounded<3>("", ',');
+    static_assert(r->size == 1 && (*r)[0].empty());
+  }
+  {
+    constexpr auto r = split_bounded<3>("a,", ',');
+    static_assert(r->size == 2 && (*r)[0] == "a" && (*r)[1].empty());
+  }
+  static_assert(split_bounded<2>("a,b,c", ',').error() ==
+                error(parse_errc::too_many_fields, 3));
+
+  auto r = split_bounded<4>("x=1;y=2", ';');
+  ASSERT_TRUE(r.has_value());
+  std::string_view fields[2];
+  std::size_t n = 0;
+  for (std::string_view field : *r)
+    fields[n++] = field;
+  ASSERT_EQ(n, 2U);
+  ASSERT_EQ(fields[0], "x=1");
+  ASSERT_EQ(fields[1], "y=2");
+}
+
+TEST(expected_parse, table) {
+  // A configuration table validated and converted at compile time.
+  struct Entry {
+    Color color;
+    int weight;
+    double scale;
+  };
+  constexpr auto parse_entry = [](std::string_view line) {
+    auto fields = split_bounded<3>(line, ':');
+    auto color = parse_enum<Color>((*fields)[0], color_names);
+    auto weight = parse_int<int>((*fields)[1]);
+    auto scale = parse_float<double>((*fields)[2]);
+    return Entry{*color, *weight, *scale};
+  };
+  constexpr std::array<Entry, 2> table = {
+      parse_entry("red:10:0.5"),
+      parse_entry("blue:-3:2e1"),
+  };
+  static_assert(table[0].color == Color::red && table[0].weight == 10 &&
+                table[0].scale == 0.5);
+  static_assert(table[1].color == Color::blue && table[1].weight == -3 &&
+                table[1].scale == 20.0);
+}
+
+// NOLINTEND(*-avoid-magic-numbers): Test values
@@ -0,0 +1,159 @@
+#include "bc/expected_task.h"
+
+#include <coroutine>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Task_error { failed = 1 };
+
+struct Wide_error {
+  // NOLINTNEXTLINE(*-explicit-constructor): Converts errors of subtasks
+  Wide_error(Task_error e) : code(static_cast<int>(e)) {}
+
+  int code;
+};
+
+expected_task<int, Task_error> value(int x) { co_return x; }
+
+expected_task<int, Task_error> failure() {
+  co_return unexpected(Task_error::failed);
+}
+
+expected<int, Task_error> parse(bool ok) {
+  if (ok)
+    return 1;
+  return unexpected(Task_error::failed);
+}
+
+// Adds the values of two subtasks; an error returns early.
+expected_task<int, Task_error> sum(bool ok, int* reached) {
+  expected<int, Task_error> a = co_await value(1);
+  int b = co_await parse(ok);
+  ++*reached;
+  co_return *a + b;
+}
+
+expected_task<int, Wide_error> widen(bool ok) {
+  // A named task: GCC 12 destroys a temporary of a conditional expression
+  // twice when the coroutine is destroyed while suspended in it.
+  expected_task<int, Task_error> t = ok ? value(3) : failure();
+  int x = co_await co_await std::move(t);
+  co_return x;
+}
+
+// Awaiting an lvalue expected copies its value.
+expected_task<std::string, Task_error> keep() {
+  expected<std::string, Task_error> e("kept");
+  std::string copy = co_await e;
+  co_return copy + "/" + *e;
+}
+
+expected_task<void, Task_error> no_value(bool ok) {
+  co_await parse(ok);
+  co_return {};
+}
+
+// A chain as deep as the argument; the stack must not grow with it.
+expected_task<int, Task_error> depth(int n) {
+  if (n == 0)
+    co_return 0;
+  int d = co_await co_await depth(n - 1);
+  co_return d + 1;
+}
+
+// Resumes the awaiting coroutine on another thread.
+struct resume_on_new_thread {
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> h) {
+    std::thread([h] { h.resume(); }).detach();
+  }
+  void await_resume() const noexcept {}
+};
+
+expected_task<std::string, Task_error> on_other_thread() {
+  std::thread::id before = std::this_thread::get_id();
+  co_await resume_on_new_thread();
+  if (std::this_thread::get_id() == before)
+    co_return unexpected(Task_error::failed);
+  co_return "moved";
+}
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(expected_task, value_and_error) {
+  EXPECT_EQ(*sync_wait(value(4)), 4);
+  auto r = sync_wait(failure());
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), Task_error::failed);
+}
+
+TEST(expected_task, lazy) {
+  int reached = 0;
+  {
+    auto t = sum(true, &reached);
+    EXPECT_EQ(reached, 0);
+  }
+  EXPECT_EQ(reached, 0);
+  EXPECT_EQ(*sync_wait(sum(true, &reached)), 2);
+  EXPECT_EQ(reached, 1);
+}
+
+TEST(expected_task, error_returns_early) {
+  int reached = 0;
+  auto r = sync_wait(sum(false, &reached));
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), Task_error::failed);
+  EXPECT_EQ(reached, 0);
+}
+
+TEST(expected_task, error_conversion) {
+  EXPECT_EQ(*sync_wait(widen(true)), 3);
+  auto r = sync_wait(widen(false));
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error().code, static_cast<int>(Task_error::failed));
+}
+
+TEST(expected_task, await_lvalue) {
+  EXPECT_EQ(*sync_wait(keep()), "kept/kept");
+}
+
+TEST(expected_task, void_value) {
+  EXPECT_TRUE(sync_wait(no_value(true)).has_value());
+  EXPECT_FALSE(sync_wait(no_value(false)).has_value());
+}
+
+TEST(expected_task, deep_chain) {
+#ifdef __OPTIMIZE__
+  constexpr int n = 1000000;
+#else
+  // Without optimization GCC does not make the transfer a tail call, and each
+  // level takes some stack.
+  constexpr int n = 10000;
+#endif
+  EXPECT_EQ(*sync_wait(depth(n)), n);
+}
+
+TEST(expected_task, resumed_on_other_thread) {
+  auto r = sync_wait(on_other_thread());
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(*r, "moved");
+}
+
+TEST(frame_allocator, recycles_frames) {
+  void* p = detail::frame_allocator::allocate(100);
+  detail::frame_allocator::deallocate(p, 100);
+  // Same size class.
+  void* q = detail::frame_allocator::allocate(128);
+  EXPECT_EQ(p, q);
+  detail::frame_allocator::deallocate(q, 128);
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
@@ -4,6 +4,7 @@
 #include "con.h"
 #include "obj.h"
 #include "obj_implicit.h"
+#include "obj_non_movable.h"
 #include "obj_throw.h"
 #include "state.h"
 
@@ -335,6 +336,112 @@ TEST(expected, value_or) {
   }
 }
 
+TEST(expected, value_or_else) {
+  // const& overload
+  {
+    const expected<Val, Err> e(std::in_place, 1);
+    int calls = 0;
+    Val val = e.value_or_else([&] {
+      ++calls;
+      return Val(10);
+    });
+    ASSERT_EQ(val.x, 1);
+    ASSERT_EQ(e->x, 1);
+    ASSERT_EQ(calls, 0);
+  }
+  {
+    const expected<Val, Err> e(unexpect, 2);
+    int calls = 0;
+    Val val = e.value_or_else([&] {
+      ++calls;
+      return Val(20);
+    });
+    ASSERT_EQ(val.x, 20);
+    ASSERT_EQ(e.error().x, 2);
+    ASSERT_EQ(calls, 1);
+  }
+  {
+    const expected<Val, Err> e(unexpect, 3);
+    Val val = e.value_or_else([] { return Con(30); });
+    ASSERT_EQ(val.x, 30);
+    ASSERT_EQ(e.error().x, 3);
+  }
+  // non-const&& overload
+  {
+    expected<Val, Err> e(std::in_place, 4);
+    int calls = 0;
+    Val val = std::move(e).value_or_else([&] {
+      ++calls;
+      return Val(40);
+    });
+    ASSERT_EQ(val.x, 4);
+    ASSERT_EQ(e->x, -1);
+    ASSERT_EQ(calls, 0);
+  }
+  {
+    expected<Val, Err> e(unexpect, 5);
+    int calls = 0;
+    Val val = std::move(e).value_or_else([&] {
+      ++calls;
+      return Val(50);
+    });
+    ASSERT_EQ(val.x, 50);
+    ASSERT_EQ(e.error().x, 5);
+    ASSERT_EQ(calls, 1);
+  }
+  {
+    expected<Val, Err> e(unexpect, 6);
+    Val val = std::move(e).value_or_else([] { return Con(60); });
+    ASSERT_EQ(val.x, 60);
+    ASSERT_EQ(e.error().x, 6);
+  }
+}
+
+TEST(expected, error_or) {
+  // const& overload
+  {
+    const expected<Val, Err> e(std::in_place, 1);
+    Err v(10);
+    Err err = e.error_or(v);
+    ASSERT_EQ(err.x, 10);
+    ASSERT_EQ(e->x, 1);
+    ASSERT_EQ(v.x, 10);
+  }
+  {
+    const expected<Val, Err> e(std::in_place, 2);
+    Err v(20);
+    Err err = e.error_or(std::move(v));
+    ASSERT_EQ(err.x, 20);
+    ASSERT_EQ(e->x, 2);
+    ASSERT_EQ(v.x, -1);
+  }
+  {
+    const expected<Val, Err> e(unexpect, 3);
+    Err v(30);
+    Err err = e.error_or(std::move(v));
+    ASSERT_EQ(err.x, 3);
+    ASSERT_EQ(e.error().x, 3);
+    ASSERT_EQ(v.x, 30);
+  }
+  // non-const&& overload
+  {
+    expected<Val, Err> e(std::in_place, 4);
+    Err v(40);
+    Err err = std::move(e).error_or(std::move(v));
+    ASSERT_EQ(err.x, 40);
+    ASSERT_EQ(e->x, 4);
+    ASSERT_EQ(v.x, -1);
+  }
+  {
+    expected<Val, Err> e(unexpect, 5);
+    Err v(50);
+    Err err = std::move(e).error_or(v);
+    ASSERT_EQ(err.x, 5);
+    ASSERT_EQ(e.error().x, -1);
+    ASSERT_EQ(v.x, 50);
+  }
+}
+
 TEST(expected, has_value) {
   {
     expected<Val, Err> e;
@@ -871,6 +978,115 @@ TEST(expected, in_place_constructor) {
   Err::reset();
 }
 
+TEST(expected, in_place_invoke_constructor) {
+  Val::reset();
+  Err::reset();
+  // Result is a prvalue T
+  {
+    expected<Val, Err> e(in_place_invoke, [] { return Val(1); });
+    ASSERT_EQ(Val::s, State::constructed);
+    ASSERT_EQ(Err::s, State::none);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 1);
+  }
+  ASSERT_EQ(Val::s, State::destructed);
+  ASSERT_EQ(Err::s, State::none);
+  Val::reset();
+  {
+    Arg arg(2);
+    expected<Val, Err> e(
+        in_place_invoke,
+        [](Arg&& a, int i) { return Val(std::move(a), i); }, std::move(arg),
+        2);
+    ASSERT_EQ(Val::s, State::constructed);
+    ASSERT_EQ(Err::s, State::none);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 2 + 2);
+    ASSERT_EQ(arg.x, -1);
+  }
+  ASSERT_EQ(Val::s, State::destructed);
+  ASSERT_EQ(Err::s, State::none);
+  Val::reset();
+  // Result is converted to T
+  {
+    expected<Val, Err> e(in_place_invoke, [] { return 3; });
+    ASSERT_EQ(Val::s, State::constructed);
+    ASSERT_EQ(Err::s, State::none);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 3);
+  }
+  ASSERT_EQ(Val::s, State::destructed);
+  ASSERT_EQ(Err::s, State::none);
+  Val::reset();
+  // T is neither copyable nor movable
+  {
+    expected<Val_non_movable, Err> e(in_place_invoke,
+                                     [] { return Val_non_movable(4); });
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 4);
+  }
+  ASSERT_EQ(Err::s, State::none);
+  {
+    auto f = [] { return Val(5); };
+    ASSERT_TRUE((std::is_constructible_v<expected<Val, Err>, in_place_invoke_t,
+                                         decltype(f)>));
+    ASSERT_FALSE((std::is_constructible_v<expected<Val, Err>,
+                                          in_place_invoke_t, decltype(f), int>));
+    ASSERT_FALSE((std::is_constructible_v<expected<Val_non_movable, Err>,
+                                          in_place_invoke_t, decltype(f)>));
+  }
+}
+
+TEST(expected, unexpect_invoke_constructor) {
+  Val::reset();
+  Err::reset();
+  // Result is a prvalue E
+  {
+    expected<Val, Err> e(unexpect_invoke, [] { return Err(1); });
+    ASSERT_EQ(Val::s, State::none);
+    ASSERT_EQ(Err::s, State::constructed);
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 1);
+  }
+  ASSERT_EQ(Val::s, State::none);
+  ASSERT_EQ(Err::s, State::destructed);
+  Err::reset();
+  {
+    Arg arg(2);
+    expected<Val, Err> e(
+        unexpect_invoke,
+        [](Arg&& a, int i) { return Err(std::move(a), i); }, std::move(arg),
+        2);
+    ASSERT_EQ(Val::s, State::none);
+    ASSERT_EQ(Err::s, State::constructed);
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 2 + 2);
+    ASSERT_EQ(arg.x, -1);
+  }
+  ASSERT_EQ(Val::s, State::none);
+  ASSERT_EQ(Err::s, State::destructed);
+  Err::reset();
+  // Result is converted to E
+  {
+    expected<Val, Err> e(unexpect_invoke, [] { return 3; });
+    ASSERT_EQ(Val::s, State::none);
+    ASSERT_EQ(Err::s, State::constructed);
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 3);
+  }
+  ASSERT_EQ(Val::s, State::none);
+  ASSERT_EQ(Err::s, State::destructed);
+  Err::reset();
+  // E is neither copyable nor movable
+  {
+    expected<Val, Err_non_movable> e(unexpect_invoke,
+                                     [] { return Err_non_movable(4); });
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 4);
+  }
+  ASSERT_EQ(Val::s, State::none);
+}
+
 TEST(expected, copy_assignment_operator) {
   Val::reset();
   Err::reset();
@@ -1029,6 +1245,136 @@ TEST(expected, move_assignment_operator) {
   Err::reset();
 }
 
+// The rollback paths of assignment: when the new member cannot be
+// constructed, the old one is kept.
+TEST(expected, copy_assignment_operator_rollback) {
+  // this->has_value() && !other.has_value() via
+  // std::is_nothrow_move_constructible_v<E>
+  {
+    expected<Val, Err_throw> other(unexpect, 1);
+    expected<Val, Err_throw> e(std::in_place, 10);
+    Val::reset();
+    bool did_throw = false;
+    try {
+      Err_throw::t = May_throw::do_throw;
+      e = other;
+    } catch (...) {
+      ASSERT_EQ(Err_throw::s, State::copy_constructed); // failed
+      did_throw = true;
+      Err_throw::t = May_throw::do_not_throw;
+    }
+    ASSERT_TRUE(did_throw);
+    ASSERT_EQ(Val::s, State::none);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 10);
+  }
+  // this->has_value() && !other.has_value() via
+  // std::is_nothrow_move_constructible_v<T>
+  {
+    expected<Val, Err_throw_2> other(unexpect, 2);
+    expected<Val, Err_throw_2> e(std::in_place, 20);
+    bool did_throw = false;
+    try {
+      Err_throw_2::t = May_throw::do_throw;
+      e = other;
+    } catch (...) {
+      ASSERT_EQ(Err_throw_2::s, State::copy_constructed); // failed
+      did_throw = true;
+      Err_throw_2::t = May_throw::do_not_throw;
+    }
+    ASSERT_TRUE(did_throw);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 20);
+  }
+  // !this->has_value() && other.has_value() via
+  // std::is_nothrow_move_constructible_v<T>
+  {
+    expected<Val_throw, Err> other(std::in_place, 3);
+    expected<Val_throw, Err> e(unexpect, 30);
+    Err::reset();
+    bool did_throw = false;
+    try {
+      Val_throw::t = May_throw::do_throw;
+      e = other;
+    } catch (...) {
+      ASSERT_EQ(Val_throw::s, State::copy_constructed); // failed
+      did_throw = true;
+      Val_throw::t = May_throw::do_not_throw;
+    }
+    ASSERT_TRUE(did_throw);
+    ASSERT_EQ(Err::s, State::none);
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 30);
+  }
+  // !this->has_value() && other.has_value() via
+  // std::is_nothrow_move_constructible_v<E>
+  {
+    expected<Val_throw_2, Err> other(std::in_place, 4);
+    expected<Val_throw_2, Err> e(unexpect, 40);
+    bool did_throw = false;
+    try {
+      Val_throw_2::t = May_throw::do_throw;
+      e = other;
+    } catch (...) {
+      ASSERT_EQ(Val_throw_2::s, State::copy_constructed); // failed
+      did_throw = true;
+      Val_throw_2::t = May_throw::do_not_throw;
+    }
+    ASSERT_TRUE(did_throw);
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 40);
+  }
+  Val::reset();
+  Err::reset();
+  Val_throw::reset();
+  Err_throw::reset();
+  Val_throw_2::reset();
+  Err_throw_2::reset();
+}
+
+TEST(expected, move_assignment_operator_rollback) {
+  // this->has_value() && !other.has_value() via
+  // std::is_nothrow_move_constructible_v<T>
+  {
+    expected<Val, Err_throw_2> other(unexpect, 5);
+    expected<Val, Err_throw_2> e(std::in_place, 50);
+    bool did_throw = false;
+    try {
+      Err_throw_2::t = May_throw::do_throw;
+      e = std::move(other);
+    } catch (...) {
+      ASSERT_EQ(Err_throw_2::s, State::move_constructed); // failed
+      did_throw = true;
+      Err_throw_2::t = May_throw::do_not_throw;
+    }
+    ASSERT_TRUE(did_throw);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 50);
+  }
+  // !this->has_value() && other.has_value() via
+  // std::is_nothrow_move_constructible_v<E>
+  {
+    expected<Val_throw_2, Err> other(std::in_place, 6);
+    expected<Val_throw_2, Err> e(unexpect, 60);
+    bool did_throw = false;
+    try {
+      Val_throw_2::t = May_throw::do_throw;
+      e = std::move(other);
+    } catch (...) {
+      ASSERT_EQ(Val_throw_2::s, State::move_constructed); // failed
+      did_throw = true;
+      Val_throw_2::t = May_throw::do_not_throw;
+    }
+    ASSERT_TRUE(did_throw);
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 60);
+  }
+  Val::reset();
+  Err::reset();
+  Val_throw_2::reset();
+  Err_throw_2::reset();
+}
+
 TEST(expected, value_assignment_operator) {
   Val::reset();
   Err::reset();
@@ -1765,6 +2111,144 @@ TEST(expected, emplace_initializer_list_overload) {
   Err::reset();
 }
 
+namespace {
+
+struct Make_val_non_movable {
+  Val_non_movable operator()(int x) const { return Val_non_movable(x); }
+};
+
+struct Make_val_non_movable_noexcept {
+  Val_non_movable operator()(int x) const noexcept {
+    return Val_non_movable(x);
+  }
+};
+
+template <class F>
+constexpr bool can_emplace_invoke =
+    requires(expected<Val_non_movable, Err>& e, F f) { e.emplace_invoke(f, 1); };
+
+} // namespace
+
+TEST(expected, emplace_invoke) {
+  Val::reset();
+  Err::reset();
+  Val_throw_2::reset();
+  // has_value() via nothrow invocation
+  {
+    expected<Val, Err> e(std::in_place, 10);
+    e.emplace_invoke([]() noexcept { return Val(1); });
+    ASSERT_EQ(Val::s, State::constructed);
+    ASSERT_EQ(Err::s, State::none);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 1);
+  }
+  ASSERT_EQ(Val::s, State::destructed);
+  ASSERT_EQ(Err::s, State::none);
+  Val::reset();
+  // has_value()
+  {
+    Arg arg(2);
+    expected<Val, Err> e(std::in_place, 20);
+    e.emplace_invoke([](Arg&& a, int i) { return Val(std::move(a), i); },
+                     std::move(arg), 2);
+    // constructed (tmp), move_assigned (this), destructed (tmp)
+    ASSERT_EQ(Val::s, State::destructed);
+    ASSERT_EQ(Err::s, State::none);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 2 + 2);
+    ASSERT_EQ(arg.x, -1);
+    Val::s = State::constructed;
+  }
+  ASSERT_EQ(Val::s, State::destructed);
+  ASSERT_EQ(Err::s, State::none);
+  Val::reset();
+  // !has_value() via nothrow invocation
+  {
+    expected<Val, Err> e(unexpect, 30);
+    Val& val = e.emplace_invoke([]() noexcept { return Val(3); });
+    ASSERT_EQ(Val::s, State::constructed);
+    ASSERT_EQ(Err::s, State::destructed);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(val.x, 3);
+    ASSERT_EQ(&val, &*e);
+    Err::reset();
+  }
+  ASSERT_EQ(Val::s, State::destructed);
+  ASSERT_EQ(Err::s, State::none);
+  Val::reset();
+  // !has_value() via std::is_nothrow_move_constructible_v<T>
+  {
+    expected<Val, Err> e(unexpect, 40);
+    e.emplace_invoke([] { return Val(4); });
+    // constructed (tmp), move_constructed (this), destructed (tmp)
+    ASSERT_EQ(Val::s, State::destructed);
+    ASSERT_EQ(Err::s, State::destructed);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 4);
+    Val::s = State::constructed;
+    Err::reset();
+  }
+  ASSERT_EQ(Val::s, State::destructed);
+  ASSERT_EQ(Err::s, State::none);
+  Val::reset();
+  // !has_value() via std::is_nothrow_move_constructible_v<E>
+  {
+    Arg arg(5);
+    expected<Val_throw_2, Err> e(unexpect, 50);
+    e.emplace_invoke(
+        [](Arg&& a, int i) { return Val_throw_2(std::move(a), i); },
+        std::move(arg), 5);
+    ASSERT_EQ(Val_throw_2::s, State::constructed);
+    ASSERT_EQ(Err::s, State::destructed);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 5 + 5);
+    Err::reset();
+  }
+  ASSERT_EQ(Val_throw_2::s, State::destructed);
+  ASSERT_EQ(Err::s, State::none);
+  Val_throw_2::reset();
+  {
+    Arg arg(6);
+    expected<Val_throw_2, Err> e(unexpect, 60);
+    bool did_throw = false;
+    try {
+      Val_throw_2::t = May_throw::do_throw;
+      e.emplace_invoke(
+          [](Arg&& a, int i) { return Val_throw_2(std::move(a), i); },
+          std::move(arg), 6);
+    } catch (...) {
+      ASSERT_EQ(Val_throw_2::s, State::constructed); // failed
+      // move_constructed (tmp), move_constructed (this), destructed (tmp)
+      ASSERT_EQ(Err::s, State::destructed);
+      did_throw = true;
+      Val_throw_2::t = May_throw::do_not_throw;
+    }
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 60);
+    ASSERT_TRUE(did_throw);
+    Val_throw_2::reset();
+    Err::s = State::constructed;
+  }
+  ASSERT_EQ(Val_throw_2::s, State::none);
+  ASSERT_EQ(Err::s, State::destructed);
+  Err::reset();
+  // T is neither copyable nor movable
+  {
+    expected<Val_non_movable, Err> e(unexpect, 70);
+    e.emplace_invoke(Make_val_non_movable_noexcept(), 7);
+    ASSERT_EQ(Err::s, State::destructed);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 7);
+    e.emplace_invoke(Make_val_non_movable_noexcept(), 8);
+    ASSERT_TRUE(e.has_value());
+    ASSERT_EQ(e->x, 8);
+    Err::reset();
+  }
+  ASSERT_EQ(Err::s, State::none);
+  ASSERT_TRUE(can_emplace_invoke<Make_val_non_movable_noexcept>);
+  ASSERT_FALSE(can_emplace_invoke<Make_val_non_movable>);
+}
+
 TEST(expected, swap_traits) {
   ASSERT_TRUE((std::is_swappable_v<expected<Val, Err>>));
   ASSERT_TRUE((std::is_nothrow_swappable_v<expected<Val, Err>>));
@@ -237,3 +237,134 @@ TEST(expected_void_constexpr, equality_operators) {
     ASSERT_FALSE(b);
   }
 }
+
+namespace {
+
+// Returns an expected that has a value if x is 0, or the error x otherwise.
+constexpr expected<void, Err> make_expected(int x) {
+  if (x == 0)
+    return expected<void, Err>();
+  return expected<void, Err>(unexpect, x);
+}
+
+// Returns 0 if e has a value, or its error otherwise.
+constexpr int result(const expected<void, Err>& e) {
+  return e.has_value() ? 0 : e.error().x;
+}
+
+constexpr int copy_assignment(int x, int y) {
+  expected<void, Err> e = make_expected(x);
+  const expected<void, Err> other = make_expected(y);
+  e = other;
+  return result(e);
+}
+
+constexpr int move_assignment(int x, int y) {
+  expected<void, Err> e = make_expected(x);
+  expected<void, Err> other = make_expected(y);
+  e = std::move(other);
+  return result(e);
+}
+
+constexpr int unexpected_assignment(int x, int y) {
+  expected<void, Err> e = make_expected(x);
+  const unexpected<Err> other(y);
+  e = other;
+  return result(e);
+}
+
+constexpr int emplace(int x) {
+  expected<void, Err> e = make_expected(x);
+  e.emplace();
+  return result(e);
+}
+
+constexpr std::pair<int, int> swap(int x, int y) {
+  expected<void, Err> e = make_expected(x);
+  expected<void, Err> other = make_expected(y);
+  e.swap(other);
+  return {result(e), result(other)};
+}
+
+} // namespace
+
+TEST(expected_void_constexpr, copy_assignment) {
+  {
+    constexpr int x = copy_assignment(0, 0);
+    ASSERT_EQ(x, 0);
+  }
+  {
+    constexpr int x = copy_assignment(0, 1);
+    ASSERT_EQ(x, 1);
+  }
+  {
+    constexpr int x = copy_assignment(2, 0);
+    ASSERT_EQ(x, 0);
+  }
+  {
+    constexpr int x = copy_assignment(3, 4);
+    ASSERT_EQ(x, 4);
+  }
+}
+
+TEST(expected_void_constexpr, move_assignment) {
+  {
+    constexpr int x = move_assignment(0, 0);
+    ASSERT_EQ(x, 0);
+  }
+  {
+    constexpr int x = move_assignment(0, 1);
+    ASSERT_EQ(x, 1 + Err::move_constructor_offset);
+  }
+  {
+    constexpr int x = move_assignment(2, 0);
+    ASSERT_EQ(x, 0);
+  }
+  {
+    constexpr int x = move_assignment(3, 4);
+    ASSERT_EQ(x, 4 + Err::move_assignment_offset);
+  }
+}
+
+TEST(expected_void_constexpr, unexpected_assignment) {
+  {
+    constexpr int x = unexpected_assignment(0, 1);
+    ASSERT_EQ(x, 1);
+  }
+  {
+    constexpr int x = unexpected_assignment(2, 3);
+    ASSERT_EQ(x, 3);
+  }
+}
+
+TEST(expected_void_constexpr, emplace) {
+  {
+    constexpr int x = emplace(0);
+    ASSERT_EQ(x, 0);
+  }
+  {
+    constexpr int x = emplace(1);
+    ASSERT_EQ(x, 0);
+  }
+}
+
+TEST(expected_void_constexpr, swap) {
+  {
+    constexpr auto x = swap(0, 0);
+    ASSERT_EQ(x, std::pair(0, 0));
+  }
+  {
+    constexpr auto x = swap(0, 1);
+    ASSERT_EQ(x, std::pair(1 + Err::move_constructor_offset, 0));
+  }
+  {
+    constexpr auto x = swap(2, 0);
+    ASSERT_EQ(x, std::pair(0, 2 + Err::move_constructor_offset));
+  }
+  {
+    constexpr auto x = swap(3, 4);
+    ASSERT_EQ(x, std::pair(4 + Err::move_assignment_offset,
+                           3 + Err::move_constructor_offset +
+                               Err::move_assignment_offset));
+  }
+}
@@ -3,6 +3,7 @@
 #include "arg.h"
 #include "obj.h"
 #include "obj_implicit.h"
+#include "obj_non_movable.h"
 #include "obj_throw.h"
 #include "state.h"
 
@@ -66,6 +67,41 @@ TEST(expected_void, value) {
   }
 }
 
+TEST(expected_void, error_or) {
+  // const& overload
+  {
+    const expected<void, Err> e(std::in_place);
+    Err v(10);
+    Err err = e.error_or(v);
+    ASSERT_EQ(err.x, 10);
+    ASSERT_EQ(v.x, 10);
+  }
+  {
+    const expected<void, Err> e(unexpect, 2);
+    Err v(20);
+    Err err = e.error_or(std::move(v));
+    ASSERT_EQ(err.x, 2);
+    ASSERT_EQ(e.error().x, 2);
+    ASSERT_EQ(v.x, 20);
+  }
+  // non-const&& overload
+  {
+    expected<void, Err> e(std::in_place);
+    Err v(30);
+    Err err = std::move(e).error_or(std::move(v));
+    ASSERT_EQ(err.x, 30);
+    ASSERT_EQ(v.x, -1);
+  }
+  {
+    expected<void, Err> e(unexpect, 4);
+    Err v(40);
+    Err err = std::move(e).error_or(v);
+    ASSERT_EQ(err.x, 4);
+    ASSERT_EQ(e.error().x, -1);
+    ASSERT_EQ(v.x, 40);
+  }
+}
+
 TEST(expected_void, has_value) {
   {
     expected<void, Err> e;
@@ -360,6 +396,28 @@ TEST(expected_void, in_place_constructor) {
   Err::reset();
 }
 
+TEST(expected_void, unexpect_invoke_constructor) {
+  Err::reset();
+  {
+    Arg arg(1);
+    expected<void, Err> e(
+        unexpect_invoke, [](Arg&& a, int i) { return Err(std::move(a), i); },
+        std::move(arg), 1);
+    ASSERT_EQ(Err::s, State::constructed);
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 1 + 1);
+    ASSERT_EQ(arg.x, -1);
+  }
+  ASSERT_EQ(Err::s, State::destructed);
+  Err::reset();
+  {
+    expected<void, Err_non_movable> e(unexpect_invoke,
+                                      [] { return Err_non_movable(2); });
+    ASSERT_FALSE(e.has_value());
+    ASSERT_EQ(e.error().x, 2);
+  }
+}
+
 TEST(expected_void, copy_assignment_operator) {
   Err::reset();
   {
@@ -478,6 +536,42 @@ TEST(expected_void, move_assignment_operator) {
   Err::reset();
 }
 
+// When the error cannot be constructed, the value is kept.
+TEST(expected_void, assignment_operator_rollback) {
+  {
+    expected<void, Err_throw> other(unexpect, 1);
+    expected<void, Err_throw> e(std::in_place);
+    bool did_throw = false;
+    try {
+      Err_throw::t = May_throw::do_throw;
+      e = other;
+    } catch (...) {
+      ASSERT_EQ(Err_throw::s, State::copy_constructed); // failed
+      did_throw = true;
+      Err_throw::t = May_throw::do_not_throw;
+    }
+    ASSERT_TRUE(did_throw);
+    ASSERT_TRUE(e.has_value());
+  }
+  {
+    expected<void, Err_throw_2> other(unexpect, 2);
+    expected<void, Err_throw_2> e(std::in_place);
+    bool did_throw = false;
+    try {
+      Err_throw_2::t = May_throw::do_throw;
+      e = std::move(other);
+    } catch (...) {
+      ASSERT_EQ(Err_throw_2::s, State::move_constructed); // failed
+      did_throw = true;
+      Err_throw_2::t = May_throw::do_not_throw;
+    }
+    ASSERT_TRUE(did_throw);
+    ASSERT_TRUE(e.has_value());
+  }
+  Err_throw::reset();
+  Err_throw_2::reset();
+}
+
 TEST(expected_void, copy_unexpected_assignment_operator) {
   Err::reset();
   Err_throw_3::reset();
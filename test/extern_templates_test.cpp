@@ -0,0 +1,64 @@
+#include "bc/expected.h"
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+// The members of these instantiations that are not constexpr are defined in
+// bcexpected_instantiations; this test links against it.
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(extern_templates, void_error_code) {
+  expected<void, std::error_code> a;
+  expected<void, std::error_code> b(
+      unexpect, std::make_error_code(std::errc::invalid_argument));
+  a = b;
+  ASSERT_FALSE(a.has_value());
+  ASSERT_EQ(a.error(), std::errc::invalid_argument);
+  b = expected<void, std::error_code>();
+  a.swap(b);
+  ASSERT_TRUE(a.has_value());
+  ASSERT_FALSE(b.has_value());
+}
+
+TEST(extern_templates, int_error_code) {
+  expected<int, std::error_code> a(1);
+  expected<int, std::error_code> b(
+      unexpect, std::make_error_code(std::errc::result_out_of_range));
+  a.swap(b);
+  ASSERT_FALSE(a.has_value());
+  ASSERT_EQ(*b, 1);
+  a = std::move(b);
+  ASSERT_EQ(*a, 1);
+}
+
+TEST(extern_templates, string_string) {
+  expected<std::string, std::string> a("value");
+  expected<std::string, std::string> b(unexpect, "error");
+  expected<std::string, std::string> c(a);
+  a = b;
+  ASSERT_EQ(a.error(), "error");
+  b = std::move(c);
+  ASSERT_EQ(*b, "value");
+  a.swap(b);
+  ASSERT_EQ(*a, "value");
+  ASSERT_EQ(b.error(), "error");
+}
+
+TEST(extern_templates, size_t_errc) {
+  expected<std::size_t, std::errc> a(std::size_t{42});
+  expected<std::size_t, std::errc> b(unexpect, std::errc::value_too_large);
+  a.swap(b);
+  ASSERT_EQ(a.error(), std::errc::value_too_large);
+  ASSERT_EQ(*b, 42U);
+  a = b;
+  ASSERT_EQ(*a, 42U);
+}
+
+// NOLINTEND(*-avoid-magic-numbers): Test values
@@ -0,0 +1,89 @@
+#include "bc/first_error.h"
+
+#include <cstddef>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(first_error, no_error) {
+  first_error<std::string> errors(4);
+  EXPECT_EQ(errors.tasks(), 4U);
+  EXPECT_FALSE(errors.stop_requested());
+  EXPECT_FALSE(errors.get_token().stop_requested());
+  EXPECT_FALSE(errors.index().has_value());
+  EXPECT_TRUE(errors.result().has_value());
+}
+
+TEST(first_error, lowest_index) {
+  first_error<std::string> errors(4);
+  EXPECT_TRUE(errors.try_set(2, "two"));
+  EXPECT_TRUE(errors.stop_requested());
+  EXPECT_TRUE(errors.get_token().stop_requested());
+  EXPECT_FALSE(errors.try_set(3, "three"));
+  EXPECT_TRUE(errors.try_set(1, "one"));
+  EXPECT_EQ(errors.index(), 1U);
+  auto r = errors.result();
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), "one");
+  EXPECT_EQ(std::move(errors).result().error(), "one");
+}
+
+TEST(first_error, first_arrival) {
+  first_error<std::string> errors(4, first_error_order::first_arrival);
+  EXPECT_TRUE(errors.try_set(2, "two"));
+  EXPECT_FALSE(errors.try_set(1, "one"));
+  EXPECT_EQ(errors.index(), 2U);
+  EXPECT_EQ(errors.result().error(), "two");
+}
+
+TEST(first_error, stop_callback) {
+  first_error<int> errors(2);
+  bool stopped = false;
+  std::stop_callback callback(errors.get_token(), [&] { stopped = true; });
+  errors.try_set(0, 1);
+  EXPECT_TRUE(stopped);
+}
+
+TEST(first_error, parallel_tasks) {
+  // Every task with an odd index fails, unless it sees the stop first. The
+  // lowest index among those that failed is kept.
+  constexpr std::size_t tasks = 16;
+  for (int round = 0; round < 50; ++round) {
+    first_error<std::size_t> errors(tasks);
+    std::vector<char> failed(tasks);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < tasks; ++i) {
+      threads.emplace_back([&, i] {
+        if (i % 2 == 1 && !errors.stop_requested()) {
+          failed[i] = 1;
+          errors.try_set(i, i * 10);
+        }
+      });
+    }
+    for (auto& t : threads)
+      t.join();
+
+    std::size_t lowest = tasks;
+    for (std::size_t i = tasks; i-- > 0;) {
+      if (failed[i] != 0)
+        lowest = i;
+    }
+    ASSERT_LT(lowest, tasks);
+    EXPECT_EQ(errors.index(), lowest);
+    EXPECT_EQ(errors.result().error(), lowest * 10);
+  }
+}
+
+TEST(first_error, index_out_of_range_terminates) {
+  first_error<std::string> errors(4);
+  EXPECT_DEATH(errors.try_set(4, "e"), "");
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
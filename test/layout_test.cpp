@@ -0,0 +1,128 @@
+#include "bc/expected.h"
+
+#include "obj.h"
+#include "obj_trivial.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Enum : unsigned char { a, b };
+
+struct Empty {};
+
+struct alignas(64) Over_aligned {
+  int x;
+};
+
+template <class... Ts>
+struct Types {};
+
+template <class T>
+constexpr std::size_t size_or_zero = sizeof(T);
+
+template <>
+constexpr std::size_t size_or_zero<void> = 0;
+
+template <class T>
+constexpr std::size_t align_or_one = alignof(T);
+
+template <>
+constexpr std::size_t align_or_one<void> = 1;
+
+template <class T>
+constexpr bool trivially_copyable_or_void = std::is_trivially_copyable_v<T>;
+
+template <>
+constexpr bool trivially_copyable_or_void<void> = true;
+
+template <class T>
+constexpr bool trivially_destructible_or_void =
+    std::is_trivially_destructible_v<T>;
+
+template <>
+constexpr bool trivially_destructible_or_void<void> = true;
+
+// expected<T, E> is a union of T and E followed by a bool, without any other
+// overhead: its alignment is the larger of the two, and its size is that of
+// the larger alternative plus one byte, rounded up to the alignment.
+template <class T, class E>
+constexpr bool check_layout() {
+  using X = expected<T, E>;
+  constexpr std::size_t align = std::max(align_or_one<T>, alignof(E));
+  constexpr std::size_t size =
+      (std::max(size_or_zero<T>, sizeof(E)) + 1 + align - 1) / align * align;
+  static_assert(alignof(X) == align);
+  static_assert(sizeof(X) == size);
+  static_assert(std::is_trivially_copyable_v<X> ==
+                (trivially_copyable_or_void<T> &&
+                 std::is_trivially_copyable_v<E>));
+  static_assert(std::is_trivially_destructible_v<X> ==
+                (trivially_destructible_or_void<T> &&
+                 std::is_trivially_destructible_v<E>));
+  static_assert(sizeof(unexpected<E>) == sizeof(E));
+  static_assert(alignof(unexpected<E>) == alignof(E));
+  return true;
+}
+
+template <class T, class... Es>
+constexpr bool check_row(Types<Es...>) {
+  return (check_layout<T, Es>() && ...);
+}
+
+template <class... Ts, class... Es>
+constexpr bool check_matrix(Types<Ts...>, Types<Es...> es) {
+  return (check_row<Ts>(es) && ...);
+}
+
+using Payloads = Types<char, int, double, long double, int*, Enum, Empty,
+                       Val_trivial, Val, std::string, Over_aligned>;
+
+using Values = Types<void, char, int, double, long double, int*, Enum, Empty,
+                     Val_trivial, Val, std::string, Over_aligned>;
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(layout, matrix) {
+  static_assert(check_matrix(Values{}, Payloads{}));
+}
+
+// Spells out the sizes that matter most, so that a change to the formula
+// above cannot hide a regression.
+TEST(layout, common_cases) {
+  static_assert(sizeof(expected<void, Enum>) == 2);
+  static_assert(sizeof(expected<void, int>) == 8);
+  static_assert(sizeof(expected<Empty, Empty>) == 2);
+  static_assert(sizeof(expected<char, char>) == 2);
+  static_assert(sizeof(expected<int, Enum>) == 8);
+  static_assert(sizeof(expected<int, int>) == 8);
+  static_assert(sizeof(expected<int*, int>) == 2 * sizeof(int*));
+  static_assert(sizeof(expected<double, int>) == 16);
+  static_assert(sizeof(expected<Val_trivial, Err_trivial>) == 8);
+  static_assert(sizeof(expected<Val, Err>) == 8);
+  static_assert(sizeof(expected<std::string, int>) ==
+                sizeof(std::string) + alignof(std::string));
+  static_assert(sizeof(expected<Over_aligned, int>) == 128);
+  static_assert(alignof(expected<Over_aligned, int>) == 64);
+  static_assert(sizeof(expected<int, Over_aligned>) == 128);
+  static_assert(alignof(expected<void, Over_aligned>) == 64);
+
+  // Small trivially copyable expected objects fit in two registers.
+  static_assert(std::is_trivially_copyable_v<expected<int, int>>);
+  static_assert(std::is_trivially_copyable_v<expected<int*, Enum>>);
+  static_assert(std::is_trivially_copyable_v<expected<void, int>>);
+  static_assert(!std::is_trivially_copyable_v<expected<std::string, int>>);
+  static_assert(!std::is_trivially_destructible_v<expected<int, std::string>>);
+  static_assert(std::is_trivially_destructible_v<expected<Val_trivial, Enum>>);
+}
+
+// NOLINTEND(*-avoid-magic-numbers): Test values
@@ -0,0 +1,73 @@
+#include "bc/expected.h"
+
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+// Copying throws once armed.
+struct Thrower {
+  explicit Thrower(int x_) : x(x_) {}
+
+  Thrower(const Thrower& other) : x(other.x) {
+    if (other.armed)
+      throw std::runtime_error("copy");
+  }
+
+  // NOLINTNEXTLINE(*-noexcept-move-operations): Not noexcept by design
+  Thrower(Thrower&& other) : x(other.x) {}
+
+  Thrower& operator=(const Thrower&) = default;
+  Thrower& operator=(Thrower&&) = default;
+  ~Thrower() = default;
+
+  int x;
+  bool armed = false;
+};
+
+struct Err {
+  std::string message;
+};
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(no_exceptions_opt_out, configuration) {
+#ifndef __cpp_exceptions
+  FAIL() << "Expected to be compiled with exceptions enabled";
+#endif
+#ifndef BC_STD_EXPECTED_NO_EXCEPTIONS
+  FAIL() << "Expected BC_STD_EXPECTED_NO_EXCEPTIONS to be defined";
+#endif
+}
+
+// Defining the macro must not drop the rollback of assignment: the old error
+// is kept when the copy of the new value throws.
+TEST(no_exceptions_opt_out, assignment_rolls_back) {
+  expected<Thrower, Err> e(unexpect, Err{"a long enough error message"});
+  expected<Thrower, Err> other(Thrower(1));
+  other->armed = true;
+  EXPECT_THROW(e = other, std::runtime_error);
+  ASSERT_FALSE(e.has_value());
+  EXPECT_EQ(e.error().message, "a long enough error message");
+
+  Thrower t(2);
+  t.armed = true;
+  EXPECT_THROW(e = t, std::runtime_error);
+  ASSERT_FALSE(e.has_value());
+  EXPECT_THROW(e.emplace(t), std::runtime_error);
+  ASSERT_FALSE(e.has_value());
+  EXPECT_EQ(e.error().message, "a long enough error message");
+}
+
+TEST(no_exceptions_opt_out, value_calls_the_handler) {
+  const expected<int, Err> e(unexpect, Err{"error"});
+  EXPECT_DEATH(static_cast<void>(e.value()), "");
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
@@ -0,0 +1,216 @@
+#include "bc/expected.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+// Copy and move are not noexcept, which selects the rollback paths when
+// exceptions are enabled. The other alternative must then be nothrow move
+// constructible for assignment and swap to be available.
+template <class Tag>
+struct Obj_not_noexcept {
+  explicit Obj_not_noexcept(int x_) : x(x_) {}
+
+  // NOLINTNEXTLINE(*-noexcept-move-operations): Not noexcept by design
+  Obj_not_noexcept(const Obj_not_noexcept& other) : x(other.x) {}
+
+  // NOLINTNEXTLINE(*-noexcept-move-operations): Not noexcept by design
+  Obj_not_noexcept(Obj_not_noexcept&& other) : x(other.x) { other.x = -1; }
+
+  Obj_not_noexcept& operator=(const Obj_not_noexcept&) = default;
+
+  // NOLINTNEXTLINE(*-noexcept-move-operations): Not noexcept by design
+  Obj_not_noexcept& operator=(Obj_not_noexcept&& other) {
+    x = other.x;
+    other.x = -2;
+    return *this;
+  }
+
+  ~Obj_not_noexcept() = default;
+
+  int x;
+};
+
+struct Val_tag {};
+using Val = Obj_not_noexcept<Val_tag>;
+
+struct Err_tag {};
+using Err = Obj_not_noexcept<Err_tag>;
+
+using Val_int = expected<Val, int>;
+using Int_err = expected<int, Err>;
+
+void print_and_abort(const bad_expected_access<void>& ex) {
+  std::fputs("handler: ", stderr);
+  std::fputs(ex.what(), stderr);
+  std::fputs("\n", stderr);
+  std::abort();
+}
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(no_exceptions, configuration) {
+#ifdef __cpp_exceptions
+  FAIL() << "Expected to be compiled with exceptions disabled";
+#endif
+#ifndef BC_STD_EXPECTED_NO_EXCEPTIONS
+  FAIL() << "Expected BC_STD_EXPECTED_NO_EXCEPTIONS to be defined";
+#endif
+  ASSERT_FALSE(std::is_nothrow_copy_constructible_v<Val>);
+  ASSERT_FALSE(std::is_nothrow_move_constructible_v<Val>);
+}
+
+TEST(no_exceptions, handler) {
+  ASSERT_EQ(get_bad_expected_access_handler(), nullptr);
+  bad_expected_access_handler prev =
+      set_bad_expected_access_handler(print_and_abort);
+  ASSERT_EQ(prev, nullptr);
+  ASSERT_EQ(get_bad_expected_access_handler(), print_and_abort);
+  prev = set_bad_expected_access_handler(nullptr);
+  ASSERT_EQ(prev, print_and_abort);
+  ASSERT_EQ(get_bad_expected_access_handler(), nullptr);
+}
+
+TEST(no_exceptions_death, value) {
+  {
+    expected<Val, Err> e(unexpect, 1);
+    EXPECT_DEATH((void)e.value(), "");
+  }
+  {
+    expected<void, Err> e(unexpect, 2);
+    EXPECT_DEATH(e.value(), "");
+  }
+  set_bad_expected_access_handler(print_and_abort);
+  {
+    const expected<Val, Err> e(unexpect, 3);
+    EXPECT_DEATH((void)e.value(), "handler: bad expected access");
+  }
+  {
+    expected<Val, Err> e(unexpect, 4);
+    EXPECT_DEATH((void)std::move(e).value(), "handler: bad expected access");
+  }
+  {
+    expected<void, Err> e(unexpect, 5);
+    EXPECT_DEATH(e.value(), "handler: bad expected access");
+  }
+  set_bad_expected_access_handler(nullptr);
+}
+
+TEST(no_exceptions, value) {
+  expected<Val, Err> e(std::in_place, 1);
+  ASSERT_EQ(e.value().x, 1);
+  expected<void, Err> e_void;
+  e_void.value();
+}
+
+TEST(no_exceptions, copy_assignment_operator) {
+  {
+    Val_int e1(std::in_place, 1);
+    const Val_int e2(unexpect, 2);
+    e1 = e2;
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error(), 2);
+  }
+  {
+    Val_int e1(unexpect, 3);
+    const Val_int e2(std::in_place, 4);
+    e1 = e2;
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(e1->x, 4);
+    ASSERT_EQ(e2->x, 4);
+  }
+  {
+    Int_err e1(5);
+    const Int_err e2(unexpect, 6);
+    e1 = e2;
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().x, 6);
+    ASSERT_EQ(e2.error().x, 6);
+  }
+  {
+    Int_err e1(unexpect, 7);
+    const Int_err e2(8);
+    e1 = e2;
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(*e1, 8);
+  }
+}
+
+TEST(no_exceptions, move_assignment_operator) {
+  {
+    Val_int e1(std::in_place, 1);
+    Val_int e2(unexpect, 2);
+    e1 = std::move(e2);
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error(), 2);
+  }
+  {
+    Val_int e1(unexpect, 3);
+    Val_int e2(std::in_place, 4);
+    e1 = std::move(e2);
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(e1->x, 4);
+    ASSERT_EQ(e2->x, -1);
+  }
+  {
+    Int_err e1(5);
+    Int_err e2(unexpect, 6);
+    e1 = std::move(e2);
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().x, 6);
+    ASSERT_EQ(e2.error().x, -1);
+  }
+  {
+    Int_err e1(unexpect, 7);
+    Int_err e2(8);
+    e1 = std::move(e2);
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(*e1, 8);
+  }
+}
+
+TEST(no_exceptions, value_assignment_operator) {
+  Val_int e(unexpect, 1);
+  e = Val(2);
+  ASSERT_TRUE(e.has_value());
+  ASSERT_EQ(e->x, 2);
+}
+
+TEST(no_exceptions, emplace) {
+  Val_int e(unexpect, 1);
+  Val& val = e.emplace(2);
+  ASSERT_TRUE(e.has_value());
+  ASSERT_EQ(val.x, 2);
+}
+
+TEST(no_exceptions, swap) {
+  {
+    Val_int e1(std::in_place, 1);
+    Val_int e2(unexpect, 2);
+    e1.swap(e2);
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error(), 2);
+    ASSERT_TRUE(e2.has_value());
+    ASSERT_EQ(e2->x, 1);
+  }
+  {
+    Int_err e1(3);
+    Int_err e2(unexpect, 4);
+    e1.swap(e2);
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().x, 4);
+    ASSERT_TRUE(e2.has_value());
+    ASSERT_EQ(*e2, 3);
+  }
+}
+
+// NOLINTEND(*-avoid-magic-numbers): Test values
@@ -189,4 +189,55 @@ using Val_trivial = Obj_trivial<Val_trivial_tag>;
 struct Err_trivial_tag {};
 using Err_trivial = Obj_trivial<Err_trivial_tag>;
 
+template <class Tag>
+struct Obj_throw {
+  constexpr explicit Obj_throw(int x_) : x(x_) {}
+
+  constexpr Obj_throw(const Obj_throw& other) : x(other.x) {}
+
+  constexpr Obj_throw(Obj_throw&& other) : x(other.x) {}
+
+  constexpr Obj_throw& operator=(const Obj_throw& other) {
+    x = other.x;
+    return *this;
+  }
+
+  constexpr Obj_throw& operator=(Obj_throw&& other) {
+    x = other.x;
+    return *this;
+  }
+
+  ~Obj_throw() = default;
+
+  int x;
+};
+
+struct Err_throw_tag {};
+using Err_throw = Obj_throw<Err_throw_tag>;
+
+template <class Tag>
+struct Obj_destructor {
+  constexpr Obj_destructor(int x_, int* destroyed_)
+      : x(x_), destroyed(destroyed_) {}
+
+  Obj_destructor(const Obj_destructor&) = default;
+
+  Obj_destructor(Obj_destructor&&) = default;
+
+  Obj_destructor& operator=(const Obj_destructor&) = default;
+
+  Obj_destructor& operator=(Obj_destructor&&) = default;
+
+  constexpr ~Obj_destructor() { ++*destroyed; }
+
+  int x;
+  int* destroyed;
+};
+
+struct Val_destructor_tag {};
+using Val_destructor = Obj_destructor<Val_destructor_tag>;
+
+struct Err_destructor_tag {};
+using Err_destructor = Obj_destructor<Err_destructor_tag>;
+
 #endif
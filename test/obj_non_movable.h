@@ -0,0 +1,27 @@
+#ifndef TEST_OBJ_NON_MOVABLE_H
+#define TEST_OBJ_NON_MOVABLE_H
+
+template <class Tag>
+struct Obj_non_movable {
+  explicit Obj_non_movable(int x_) noexcept : x(x_) {}
+
+  Obj_non_movable(const Obj_non_movable&) = delete;
+
+  Obj_non_movable(Obj_non_movable&&) = delete;
+
+  Obj_non_movable& operator=(const Obj_non_movable&) = delete;
+
+  Obj_non_movable& operator=(Obj_non_movable&&) = delete;
+
+  ~Obj_non_movable() = default;
+
+  int x;
+};
+
+struct Val_non_movable_tag {};
+using Val_non_movable = Obj_non_movable<Val_non_movable_tag>;
+
+struct Err_non_movable_tag {};
+using Err_non_movable = Obj_non_movable<Err_non_movable_tag>;
+
+#endif
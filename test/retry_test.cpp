@@ -0,0 +1,172 @@
+#include "bc/retry.h"
+
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+using namespace std::chrono_literals;
+
+namespace {
+
+enum class Fetch_error { timeout = 1, not_found };
+
+// A clock and a sleeper that only advance a counter.
+struct Fake_time {
+  std::chrono::nanoseconds now{0};
+  std::vector<std::chrono::nanoseconds> sleeps;
+  int clock_reads = 0;
+};
+
+struct Fake_clock {
+  using duration = std::chrono::nanoseconds;
+  using time_point = std::chrono::time_point<Fake_clock, duration>;
+
+  time_point now() const noexcept {
+    ++time->clock_reads;
+    return time_point(time->now);
+  }
+
+  Fake_time* time;
+};
+
+struct Fake_sleeper {
+  void operator()(std::chrono::nanoseconds d) const {
+    time->sleeps.push_back(d);
+    time->now += d;
+  }
+
+  Fake_time* time;
+};
+
+struct Is_timeout {
+  bool operator()(Fetch_error e) const noexcept {
+    return e == Fetch_error::timeout;
+  }
+};
+
+using fake_policy = retry_policy<Is_timeout, Fake_clock, Fake_sleeper>;
+
+fake_policy make_policy(Fake_time& time, retry_options options) {
+  return {options, {}, {&time}, {&time}};
+}
+
+// Fails with error for the first failures calls.
+struct Flaky {
+  expected<int, Fetch_error> operator()() {
+    ++calls;
+    if (calls <= failures)
+      return unexpected(error);
+    return calls;
+  }
+
+  int failures;
+  Fetch_error error = Fetch_error::timeout;
+  int calls = 0;
+};
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(retry, first_success_does_not_read_the_clock) {
+  Fake_time time;
+  Flaky f{0};
+  auto r = retry(make_policy(time, {}), f);
+  EXPECT_EQ(*r, 1);
+  EXPECT_EQ(time.clock_reads, 0);
+  EXPECT_TRUE(time.sleeps.empty());
+}
+
+TEST(retry, exponential_backoff) {
+  Fake_time time;
+  Flaky f{3};
+  auto r = retry(make_policy(time, {.max_attempts = 5,
+                                    .initial_delay = 10ms,
+                                    .multiplier = 3.0,
+                                    .max_delay = 50ms,
+                                    .jitter = 0.0}),
+                 f);
+  EXPECT_EQ(*r, 4);
+  EXPECT_EQ(time.sleeps,
+            (std::vector<std::chrono::nanoseconds>{10ms, 30ms, 50ms}));
+}
+
+TEST(retry, attempt_budget) {
+  Fake_time time;
+  Flaky f{10};
+  auto r = retry(make_policy(time, {.max_attempts = 3, .jitter = 0.0}), f);
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), Fetch_error::timeout);
+  EXPECT_EQ(f.calls, 3);
+  EXPECT_EQ(time.sleeps.size(), 2U);
+}
+
+TEST(retry, error_not_retryable) {
+  Fake_time time;
+  Flaky f{10, Fetch_error::not_found};
+  auto r = retry(make_policy(time, {.max_attempts = 5}), f);
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), Fetch_error::not_found);
+  EXPECT_EQ(f.calls, 1);
+}
+
+TEST(retry, deadline) {
+  Fake_time time;
+  Flaky f{10};
+  auto r = retry(make_policy(time, {.max_attempts = 10,
+                                    .initial_delay = 10ms,
+                                    .multiplier = 2.0,
+                                    .jitter = 0.0,
+                                    .deadline = 100ms}),
+                 f);
+  ASSERT_FALSE(r.has_value());
+  // 10 + 20 + 40 ms; the next delay of 80 ms would end after the deadline.
+  EXPECT_EQ(f.calls, 4);
+  EXPECT_EQ(time.now, 70ms);
+}
+
+TEST(retry, jitter) {
+  Fake_time time;
+  Flaky f{20};
+  static_cast<void>(retry(make_policy(time, {.max_attempts = 21,
+                                             .initial_delay = 100ms,
+                                             .multiplier = 1.0,
+                                             .jitter = 0.5}),
+                          f));
+  ASSERT_EQ(time.sleeps.size(), 20U);
+  bool varies = false;
+  for (auto d : time.sleeps) {
+    EXPECT_GE(d, 50ms);
+    EXPECT_LE(d, 100ms);
+    varies = varies || d != time.sleeps.front();
+  }
+  EXPECT_TRUE(varies);
+}
+
+TEST(retry, default_policy) {
+  Flaky f{1};
+  auto r = retry(retry_policy{{.initial_delay = 1ms}}, f);
+  EXPECT_EQ(*r, 2);
+}
+
+TEST(retry, uncapped_delay_saturates) {
+  Fake_time time;
+  Flaky f{5};
+  auto r = retry(make_policy(time, {.max_attempts = 3,
+                                    .initial_delay = 1s,
+                                    .multiplier = 1e30,
+                                    .max_delay = retry_options::duration::max(),
+                                    .jitter = 0.0}),
+                 f);
+  // The second delay saturates at max_delay, past the deadline.
+  EXPECT_EQ(r.error(), Fetch_error::timeout);
+  ASSERT_EQ(time.sleeps.size(), 1U);
+  EXPECT_EQ(detail::to_nanoseconds(1e30), retry_options::duration::max());
+  EXPECT_EQ(detail::to_nanoseconds(static_cast<double>(
+                retry_options::duration::max().count())),
+            retry_options::duration::max());
+}
+
+// NOLINTEND(*-avoid-magic-numbers)
@@ -0,0 +1,141 @@
+#include "bc/expected.h"
+
+#include "obj.h"
+#include "obj_throw.h"
+#include "obj_trivial.h"
+
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+using Exp = expected<Val, Err>;
+using E_e_trivial = expected<Val, Err_trivial>;
+using E_t_trivial = expected<Val_trivial, Err>;
+using E_trivial = expected<Val_trivial, Err_trivial>;
+
+using Exp_void = expected<void, Err>;
+using E_void_trivial = expected<void, Err_trivial>;
+
+using E_e_throw_2 = expected<Val, Err_throw_2>;
+using E_t_throw_2 = expected<Val_throw_2, Err>;
+using E_throw_2 = expected<Val_throw_2, Err_throw_2>;
+
+using E_void_throw_2 = expected<void, Err_throw_2>;
+
+} // namespace
+
+TEST(expected_special_members, copy_constructor) {
+  ASSERT_FALSE(std::is_trivially_copy_constructible_v<Val>);
+  ASSERT_FALSE(std::is_trivially_copy_constructible_v<Err>);
+  ASSERT_TRUE(std::is_trivially_copy_constructible_v<Val_trivial>);
+  ASSERT_TRUE(std::is_trivially_copy_constructible_v<Err_trivial>);
+
+  ASSERT_TRUE(std::is_copy_constructible_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_copy_constructible_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_copy_constructible_v<E_e_trivial>);
+  ASSERT_FALSE(std::is_trivially_copy_constructible_v<E_t_trivial>);
+  ASSERT_TRUE(std::is_trivially_copy_constructible_v<E_trivial>);
+
+  ASSERT_TRUE(std::is_copy_constructible_v<Exp_void>);
+  ASSERT_FALSE(std::is_trivially_copy_constructible_v<Exp_void>);
+  ASSERT_TRUE(std::is_trivially_copy_constructible_v<E_void_trivial>);
+}
+
+TEST(expected_special_members, move_constructor) {
+  // is_trivially_move_constructible
+
+  ASSERT_FALSE(std::is_trivially_move_constructible_v<Val>);
+  ASSERT_FALSE(std::is_trivially_move_constructible_v<Err>);
+  ASSERT_TRUE(std::is_trivially_move_constructible_v<Val_trivial>);
+  ASSERT_TRUE(std::is_trivially_move_constructible_v<Err_trivial>);
+
+  ASSERT_TRUE(std::is_move_constructible_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_move_constructible_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_move_constructible_v<E_e_trivial>);
+  ASSERT_FALSE(std::is_trivially_move_constructible_v<E_t_trivial>);
+  ASSERT_TRUE(std::is_trivially_move_constructible_v<E_trivial>);
+
+  ASSERT_TRUE(std::is_move_constructible_v<Exp_void>);
+  ASSERT_FALSE(std::is_trivially_move_constructible_v<Exp_void>);
+  ASSERT_TRUE(std::is_trivially_move_constructible_v<E_void_trivial>);
+
+  // is_nothrow_move_constructible
+
+  ASSERT_TRUE(std::is_nothrow_move_constructible_v<Val>);
+  ASSERT_TRUE(std::is_nothrow_move_constructible_v<Err>);
+  ASSERT_FALSE(std::is_nothrow_move_constructible_v<Val_throw_2>);
+  ASSERT_FALSE(std::is_nothrow_move_constructible_v<Err_throw_2>);
+
+  ASSERT_TRUE(std::is_nothrow_move_constructible_v<Exp>);
+  ASSERT_FALSE(std::is_nothrow_move_constructible_v<E_e_throw_2>);
+  ASSERT_FALSE(std::is_nothrow_move_constructible_v<E_t_throw_2>);
+  ASSERT_FALSE(std::is_nothrow_move_constructible_v<E_throw_2>);
+
+  ASSERT_TRUE(std::is_nothrow_move_constructible_v<Exp_void>);
+  ASSERT_FALSE(std::is_nothrow_move_constructible_v<E_void_throw_2>);
+}
+
+TEST(expected_special_members, copy_assignment) {
+  ASSERT_FALSE(std::is_trivially_copy_assignable_v<Val>);
+  ASSERT_FALSE(std::is_trivially_copy_assignable_v<Err>);
+  ASSERT_TRUE(std::is_trivially_copy_assignable_v<Val_trivial>);
+  ASSERT_TRUE(std::is_trivially_copy_assignable_v<Err_trivial>);
+
+  ASSERT_TRUE(std::is_copy_assignable_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_copy_assignable_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_copy_assignable_v<E_e_trivial>);
+  ASSERT_FALSE(std::is_trivially_copy_assignable_v<E_t_trivial>);
+  ASSERT_TRUE(std::is_trivially_copy_assignable_v<E_trivial>);
+
+  ASSERT_TRUE(std::is_copy_assignable_v<Exp_void>);
+  ASSERT_FALSE(std::is_trivially_copy_assignable_v<Exp_void>);
+  ASSERT_TRUE(std::is_trivially_copy_assignable_v<E_void_trivial>);
+}
+
+TEST(expected_special_members, move_assignment) {
+  // is_trivially_move_assignable
+
+  ASSERT_FALSE(std::is_trivially_move_assignable_v<Val>);
+  ASSERT_FALSE(std::is_trivially_move_assignable_v<Err>);
+  ASSERT_TRUE(std::is_trivially_move_assignable_v<Val_trivial>);
+  ASSERT_TRUE(std::is_trivially_move_assignable_v<Err_trivial>);
+
+  ASSERT_TRUE(std::is_move_assignable_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_move_assignable_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_move_assignable_v<E_e_trivial>);
+  ASSERT_FALSE(std::is_trivially_move_assignable_v<E_t_trivial>);
+  ASSERT_TRUE(std::is_trivially_move_assignable_v<E_trivial>);
+
+  ASSERT_TRUE(std::is_move_assignable_v<Exp_void>);
+  ASSERT_FALSE(std::is_trivially_move_assignable_v<Exp_void>);
+  ASSERT_TRUE(std::is_trivially_move_assignable_v<E_void_trivial>);
+
+  // is_nothrow_move_assignable
+
+  ASSERT_TRUE(std::is_nothrow_move_assignable_v<Val>);
+  ASSERT_TRUE(std::is_nothrow_move_assignable_v<Err>);
+  ASSERT_FALSE(std::is_nothrow_move_assignable_v<Val_throw_2>);
+  ASSERT_FALSE(std::is_nothrow_move_assignable_v<Err_throw_2>);
+
+  ASSERT_TRUE(std::is_nothrow_move_assignable_v<Exp>);
+  ASSERT_FALSE(std::is_nothrow_move_assignable_v<E_e_throw_2>);
+  ASSERT_FALSE(std::is_nothrow_move_assignable_v<E_t_throw_2>);
+  ASSERT_FALSE(std::is_nothrow_move_assignable_v<E_throw_2>);
+
+  ASSERT_TRUE(std::is_nothrow_move_assignable_v<Exp_void>);
+  ASSERT_FALSE(std::is_nothrow_move_assignable_v<E_void_throw_2>);
+}
+
+TEST(expected_special_members, destructor) {
+  ASSERT_FALSE(std::is_trivially_destructible_v<Exp>);
+  ASSERT_FALSE(std::is_trivially_destructible_v<E_e_trivial>);
+  ASSERT_FALSE(std::is_trivially_destructible_v<E_t_trivial>);
+  ASSERT_TRUE(std::is_trivially_destructible_v<E_trivial>);
+
+  ASSERT_FALSE(std::is_trivially_destructible_v<Exp_void>);
+  ASSERT_TRUE(std::is_trivially_destructible_v<E_void_trivial>);
+}
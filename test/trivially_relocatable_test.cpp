@@ -0,0 +1,289 @@
+#include "bc/expected.h"
+#include "bc/relocatable_vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+// Owns a heap allocated value, so it is not trivially copyable, but it is
+// trivially relocatable. Counts moves and destructions to check that the
+// relocation paths use neither.
+template <class Tag>
+struct Obj_reloc {
+  inline static int move_count = 0;
+  inline static int destruct_count = 0;
+  static void reset() {
+    move_count = 0;
+    destruct_count = 0;
+  }
+
+  explicit Obj_reloc(int x) : p(std::make_unique<int>(x)) {}
+
+  Obj_reloc(const Obj_reloc& other) : p(std::make_unique<int>(*other.p)) {}
+
+  Obj_reloc(Obj_reloc&& other) noexcept : p(std::move(other.p)) {
+    ++move_count;
+  }
+
+  Obj_reloc& operator=(const Obj_reloc& other) {
+    p = std::make_unique<int>(*other.p);
+    return *this;
+  }
+
+  Obj_reloc& operator=(Obj_reloc&& other) noexcept {
+    p = std::move(other.p);
+    ++move_count;
+    return *this;
+  }
+
+  ~Obj_reloc() { ++destruct_count; }
+
+  std::unique_ptr<int> p;
+};
+
+// Copy and move are not noexcept and throw on request.
+template <class Tag>
+struct Obj_may_throw {
+  inline static bool do_throw = false;
+
+  explicit Obj_may_throw(int x_) : x(x_) {}
+
+  Obj_may_throw(const Obj_may_throw& other) : x(other.x) {
+    if (do_throw)
+      throw 0;
+  }
+
+  // NOLINTNEXTLINE(*-noexcept-move-operations): Not noexcept by design
+  Obj_may_throw(Obj_may_throw&& other) : x(other.x) {
+    if (do_throw)
+      throw 0;
+  }
+
+  Obj_may_throw& operator=(const Obj_may_throw&) = default;
+
+  // NOLINTNEXTLINE(*-noexcept-move-operations): Not noexcept by design
+  Obj_may_throw& operator=(Obj_may_throw&&) = default;
+
+  ~Obj_may_throw() = default;
+
+  int x;
+};
+
+struct Val_tag {};
+struct Err_tag {};
+
+using Val_reloc = Obj_reloc<Val_tag>;
+using Err_reloc = Obj_reloc<Err_tag>;
+using Val_may_throw = Obj_may_throw<Val_tag>;
+using Err_may_throw = Obj_may_throw<Err_tag>;
+
+struct Not_relocatable {
+  Not_relocatable() = default;
+  Not_relocatable(const Not_relocatable&) {}
+};
+
+} // namespace
+
+template <class Tag>
+struct bc::is_trivially_relocatable<Obj_reloc<Tag>> : std::true_type {};
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+// NOLINTBEGIN(clang-analyzer-cplusplus.Move)
+
+TEST(trivially_relocatable, trait) {
+  static_assert(is_trivially_relocatable_v<int>);
+  static_assert(is_trivially_relocatable_v<int*>);
+  static_assert(!is_trivially_relocatable_v<Not_relocatable>);
+  static_assert(is_trivially_relocatable_v<Val_reloc>);
+  static_assert(!is_trivially_relocatable_v<Val_may_throw>);
+
+  static_assert(is_trivially_relocatable_v<std::unique_ptr<int>>);
+  static_assert(is_trivially_relocatable_v<std::unique_ptr<int[]>>);
+  static_assert(is_trivially_relocatable_v<std::shared_ptr<int>>);
+  static_assert(is_trivially_relocatable_v<std::weak_ptr<int>>);
+  static_assert(is_trivially_relocatable_v<std::vector<int>>);
+  static_assert(is_trivially_relocatable_v<std::vector<Not_relocatable>>);
+
+  static_assert(is_trivially_relocatable_v<unexpected<int>>);
+  static_assert(is_trivially_relocatable_v<unexpected<Err_reloc>>);
+  static_assert(!is_trivially_relocatable_v<unexpected<Not_relocatable>>);
+
+  static_assert(is_trivially_relocatable_v<expected<int, int>>);
+  static_assert(is_trivially_relocatable_v<expected<Val_reloc, Err_reloc>>);
+  static_assert(is_trivially_relocatable_v<expected<void, Err_reloc>>);
+  static_assert(
+      is_trivially_relocatable_v<expected<std::unique_ptr<int>, Err_reloc>>);
+  static_assert(!is_trivially_relocatable_v<expected<Val_reloc, Err_may_throw>>);
+  static_assert(!is_trivially_relocatable_v<expected<Val_may_throw, Err_reloc>>);
+  static_assert(!is_trivially_relocatable_v<expected<void, Err_may_throw>>);
+}
+
+TEST(trivially_relocatable, copy_assignment_operator) {
+  using E = expected<Val_reloc, Err_may_throw>;
+  using E2 = expected<Val_may_throw, Err_reloc>;
+  // T is relocated while E is copy constructed
+  Val_reloc::reset();
+  {
+    E e1(std::in_place, 1);
+    const int* p = e1->p.get();
+    const E e2(unexpect, 2);
+    Err_may_throw::do_throw = true;
+    EXPECT_THROW(e1 = e2, int);
+    Err_may_throw::do_throw = false;
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(e1->p.get(), p);
+    ASSERT_EQ(*e1->p, 1);
+    ASSERT_EQ(Val_reloc::move_count, 0);
+    ASSERT_EQ(Val_reloc::destruct_count, 0);
+    e1 = e2;
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().x, 2);
+    ASSERT_EQ(Val_reloc::move_count, 0);
+    ASSERT_EQ(Val_reloc::destruct_count, 1);
+  }
+  // E is relocated while T is copy constructed
+  Err_reloc::reset();
+  {
+    E2 e1(unexpect, 3);
+    const int* p = e1.error().p.get();
+    const E2 e2(std::in_place, 4);
+    Val_may_throw::do_throw = true;
+    EXPECT_THROW(e1 = e2, int);
+    Val_may_throw::do_throw = false;
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().p.get(), p);
+    ASSERT_EQ(*e1.error().p, 3);
+    ASSERT_EQ(Err_reloc::move_count, 0);
+    ASSERT_EQ(Err_reloc::destruct_count, 0);
+    e1 = e2;
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(e1->x, 4);
+    ASSERT_EQ(Err_reloc::move_count, 0);
+    ASSERT_EQ(Err_reloc::destruct_count, 1);
+  }
+}
+
+TEST(trivially_relocatable, move_assignment_operator) {
+  using E = expected<Val_reloc, Err_may_throw>;
+  using E2 = expected<Val_may_throw, Err_reloc>;
+  // T is relocated while E is move constructed
+  Val_reloc::reset();
+  {
+    E e1(std::in_place, 1);
+    const int* p = e1->p.get();
+    E e2(unexpect, 2);
+    Err_may_throw::do_throw = true;
+    EXPECT_THROW(e1 = std::move(e2), int);
+    Err_may_throw::do_throw = false;
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(e1->p.get(), p);
+    ASSERT_EQ(*e1->p, 1);
+    ASSERT_EQ(Val_reloc::move_count, 0);
+    ASSERT_EQ(Val_reloc::destruct_count, 0);
+    e1 = std::move(e2);
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().x, 2);
+    ASSERT_EQ(Val_reloc::move_count, 0);
+    ASSERT_EQ(Val_reloc::destruct_count, 1);
+  }
+  // E is relocated while T is move constructed
+  Err_reloc::reset();
+  {
+    E2 e1(unexpect, 3);
+    const int* p = e1.error().p.get();
+    E2 e2(std::in_place, 4);
+    Val_may_throw::do_throw = true;
+    EXPECT_THROW(e1 = std::move(e2), int);
+    Val_may_throw::do_throw = false;
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().p.get(), p);
+    ASSERT_EQ(*e1.error().p, 3);
+    ASSERT_EQ(Err_reloc::move_count, 0);
+    ASSERT_EQ(Err_reloc::destruct_count, 0);
+    e1 = std::move(e2);
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(e1->x, 4);
+    ASSERT_EQ(Err_reloc::move_count, 0);
+    ASSERT_EQ(Err_reloc::destruct_count, 1);
+  }
+}
+
+TEST(trivially_relocatable, swap) {
+  using E = expected<Val_reloc, Err_reloc>;
+  Val_reloc::reset();
+  Err_reloc::reset();
+  {
+    E e1(std::in_place, 1);
+    E e2(unexpect, 2);
+    const int* p1 = e1->p.get();
+    const int* p2 = e2.error().p.get();
+    e1.swap(e2);
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().p.get(), p2);
+    ASSERT_EQ(*e1.error().p, 2);
+    ASSERT_TRUE(e2.has_value());
+    ASSERT_EQ(e2->p.get(), p1);
+    ASSERT_EQ(*e2->p, 1);
+    e1.swap(e2);
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_EQ(*e1->p, 1);
+    ASSERT_FALSE(e2.has_value());
+    ASSERT_EQ(*e2.error().p, 2);
+    ASSERT_EQ(Val_reloc::move_count, 0);
+    ASSERT_EQ(Val_reloc::destruct_count, 0);
+    ASSERT_EQ(Err_reloc::move_count, 0);
+    ASSERT_EQ(Err_reloc::destruct_count, 0);
+  }
+  ASSERT_EQ(Val_reloc::destruct_count, 1);
+  ASSERT_EQ(Err_reloc::destruct_count, 1);
+  // T is void
+  Err_reloc::reset();
+  {
+    expected<void, Err_reloc> e1;
+    expected<void, Err_reloc> e2(unexpect, 3);
+    const int* p = e2.error().p.get();
+    e1.swap(e2);
+    ASSERT_FALSE(e1.has_value());
+    ASSERT_EQ(e1.error().p.get(), p);
+    ASSERT_TRUE(e2.has_value());
+    e1.swap(e2);
+    ASSERT_TRUE(e1.has_value());
+    ASSERT_FALSE(e2.has_value());
+    ASSERT_EQ(*e2.error().p, 3);
+    ASSERT_EQ(Err_reloc::move_count, 0);
+    ASSERT_EQ(Err_reloc::destruct_count, 0);
+  }
+  ASSERT_EQ(Err_reloc::destruct_count, 1);
+  // Sorting moves and swaps elements in every state
+  {
+    std::vector<expected<std::unique_ptr<int>, std::shared_ptr<int>>> v;
+    for (int i = 0; i != 32; ++i) {
+      if (i % 3 == 0)
+        v.emplace_back(unexpect, std::make_shared<int>(i));
+      else
+        v.emplace_back(std::make_unique<int>(i));
+    }
+    auto key = [](const auto& e) {
+      return e.has_value() ? *e.value() : -*e.error();
+    };
+    std::sort(v.begin(), v.end(), [&](const auto& x, const auto& y) {
+      return key(x) > key(y);
+    });
+    for (std::size_t i = 1; i != v.size(); ++i)
+      ASSERT_GE(key(v[i - 1]), key(v[i]));
+    ASSERT_EQ(key(v.front()), 31);
+    ASSERT_EQ(key(v.back()), -30);
+  }
+}
+
+// NOLINTEND(clang-analyzer-cplusplus.Move)
+// NOLINTEND(*-avoid-magic-numbers): Test values
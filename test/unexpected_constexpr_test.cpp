@@ -254,3 +254,36 @@ TEST(unexpected_constexpr, equality_operators) {
 }
 
 // NOLINTEND(*-avoid-magic-numbers): Test values
+
+namespace {
+
+constexpr std::pair<int, int> swap_member_function(int x, int y) {
+  unexpected<Err> e1(x);
+  unexpected<Err> e2(y);
+  e1.swap(e2);
+  return {e1.value().x, e2.value().x};
+}
+
+constexpr std::pair<int, int> swap_free_function(int x, int y) {
+  unexpected<Err> e1(x);
+  unexpected<Err> e2(y);
+  swap(e1, e2);
+  return {e1.value().x, e2.value().x};
+}
+
+} // namespace
+
+TEST(unexpected_constexpr, swap) {
+  // std::swap moves e1 to a temporary, e2 to e1, and the temporary to e2.
+  constexpr std::pair<int, int> expected_result(
+      2 + Err::move_assignment_offset,
+      1 + Err::move_constructor_offset + Err::move_assignment_offset);
+  {
+    constexpr auto x = swap_member_function(1, 2);
+    ASSERT_EQ(x, expected_result);
+  }
+  {
+    constexpr auto x = swap_free_function(1, 2);
+    ASSERT_EQ(x, expected_result);
+  }
+}
@@ -3,7 +3,9 @@
 #include "arg.h"
 #include "obj.h"
 #include "obj_implicit.h"
+#include "obj_non_movable.h"
 #include "obj_throw.h"
+#include "state.h"
 
 #include <type_traits>
 #include <utility>
@@ -158,6 +160,22 @@ TEST(unexpected, constructors) {
     ASSERT_EQ(e.value().x, 8 + 8 + 8);
     ASSERT_EQ(arg.x, -1);
   }
+  // (in_place_invoke_t, F&&, Args&&...)
+  {
+    Err::reset();
+    Arg arg(13);
+    unexpected<Err> e(
+        in_place_invoke, [](Arg&& a, int i) { return Err(std::move(a), i); },
+        std::move(arg), 13);
+    ASSERT_EQ(Err::s, State::constructed);
+    ASSERT_EQ(e.value().x, 13 + 13);
+    ASSERT_EQ(arg.x, -1);
+  }
+  {
+    unexpected<Err_non_movable> e(in_place_invoke,
+                                  [] { return Err_non_movable(14); });
+    ASSERT_EQ(e.value().x, 14);
+  }
 }
 
 TEST(unexpected, assignment_operators) {
@@ -0,0 +1,211 @@
+#include "bc/when_all.h"
+
+#include <atomic>
+#include <cstddef>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace bc;
+
+namespace {
+
+enum class Task_error { failed = 1, other };
+
+struct Counting_job : pool_job {
+  explicit Counting_job(std::atomic<int>* c) : count(c) {
+    run = [](pool_job& j) {
+      static_cast<Counting_job&>(j).count->fetch_add(1);
+    };
+  }
+
+  std::atomic<int>* count;
+};
+
+expected<int, Task_error> fib(work_stealing_pool& pool, int n) {
+  if (n < 2)
+    return n;
+  auto r = when_all(
+      pool, [&] { return fib(pool, n - 1); },
+      [&] { return fib(pool, n - 2); });
+  if (!r.has_value())
+    return unexpected(r.error());
+  return std::get<0>(*r) + std::get<1>(*r);
+}
+
+} // namespace
+
+// NOLINTBEGIN(*-avoid-magic-numbers): Test values
+
+TEST(chase_lev_deque, owner_and_thief) {
+  detail::chase_lev_deque d(2);
+  pool_job a;
+  pool_job b;
+  pool_job c;
+  EXPECT_EQ(d.pop(), nullptr);
+  EXPECT_EQ(d.steal(), nullptr);
+  EXPECT_TRUE(d.push(&a));
+  EXPECT_TRUE(d.push(&b));
+  EXPECT_FALSE(d.push(&c));
+  // The owner takes the newest job and a thief the oldest.
+  EXPECT_EQ(d.pop(), &b);
+  EXPECT_EQ(d.steal(), &a);
+  EXPECT_EQ(d.pop(), nullptr);
+  EXPECT_EQ(d.steal(), nullptr);
+}
+
+TEST(chase_lev_deque, every_job_taken_once) {
+  constexpr int jobs = 20000;
+  std::vector<pool_job> storage(jobs);
+  std::vector<std::atomic<int>> taken(jobs);
+  detail::chase_lev_deque d(64);
+  std::atomic<bool> done{false};
+
+  auto take = [&](pool_job* j) {
+    if (j != nullptr)
+      taken[static_cast<std::size_t>(j - storage.data())].fetch_add(1);
+  };
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 3; ++i) {
+    thieves.emplace_back([&] {
+      while (!done.load()) {
+        pool_job* j = d.steal();
+        if (j == nullptr)
+          std::this_thread::yield();
+        take(j);
+      }
+    });
+  }
+  for (int i = 0; i < jobs;) {
+    if (d.push(&storage[static_cast<std::size_t>(i)]))
+      ++i;
+    else
+      std::this_thread::yield();
+    if (i % 3 == 0)
+      take(d.pop());
+  }
+  for (pool_job* j = d.pop(); j != nullptr; j = d.pop())
+    take(j);
+  done.store(true);
+  for (auto& t : thieves)
+    t.join();
+
+  int wrong = 0;
+  for (auto& t : taken)
+    wrong += t.load() != 1;
+  EXPECT_EQ(wrong, 0);
+}
+
+TEST(work_stealing_pool, submit_from_outside) {
+  std::atomic<int> count{0};
+  std::vector<Counting_job> jobs(1000, Counting_job(&count));
+  {
+    work_stealing_pool pool(3);
+    EXPECT_EQ(pool.size(), 3U);
+    for (auto& j : jobs)
+      pool.submit(j);
+    pool.wait_until([&] { return count.load() == 1000; });
+  }
+  EXPECT_EQ(count.load(), 1000);
+}
+
+TEST(work_stealing_pool, queued_jobs_run_before_destruction) {
+  std::atomic<int> count{0};
+  std::vector<Counting_job> jobs(100, Counting_job(&count));
+  {
+    work_stealing_pool pool(2);
+    for (auto& j : jobs)
+      pool.submit(j);
+  }
+  EXPECT_EQ(count.load(), 100);
+}
+
+TEST(when_all, values) {
+  work_stealing_pool pool(2);
+  auto r = when_all(
+      pool, [] { return expected<int, Task_error>(1); },
+      [] { return expected<std::string, Task_error>("two"); },
+      [] { return expected<void, Task_error>(); });
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(std::get<0>(*r), 1);
+  EXPECT_EQ(std::get<1>(*r), "two");
+  static_assert(
+      std::is_same_v<std::tuple_element_t<2, std::remove_cvref_t<decltype(*r)>>,
+                     std::monostate>);
+}
+
+TEST(when_all, lowest_index_error) {
+  work_stealing_pool pool(2);
+  for (int i = 0; i < 100; ++i) {
+    auto r = when_all(
+        pool, [] { return expected<int, Task_error>(1); },
+        [] { return expected<int, Task_error>(unexpect, Task_error::failed); },
+        [] { return expected<int, Task_error>(unexpect, Task_error::other); });
+    ASSERT_FALSE(r.has_value());
+    // The first callable runs on the calling thread, so the second one may be
+    // skipped once the third has failed.
+    EXPECT_TRUE(r.error() == Task_error::failed ||
+                r.error() == Task_error::other);
+  }
+}
+
+TEST(when_all, error_stops_the_others) {
+  work_stealing_pool pool(2);
+  std::atomic<bool> started{false};
+  auto r = when_all(
+      pool,
+      [&] {
+        // Fails once the other callable is running.
+        while (!started.load())
+          std::this_thread::yield();
+        return expected<int, Task_error>(unexpect, Task_error::failed);
+      },
+      [&](std::stop_token token) {
+        started.store(true);
+        while (!token.stop_requested())
+          std::this_thread::yield();
+        return expected<int, Task_error>(unexpect, Task_error::other);
+      });
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), Task_error::failed);
+}
+
+TEST(when_all, nested) {
+  work_stealing_pool pool(4);
+  auto r = fib(pool, 16);
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(*r, 987);
+}
+
+TEST(when_any, first_success) {
+  work_stealing_pool pool(2);
+  auto r = when_any(
+      pool,
+      [](std::stop_token token) {
+        while (!token.stop_requested())
+          std::this_thread::yield();
+        return expected<int, Task_error>(unexpect, Task_error::other);
+      },
+      [] { return expected<int, Task_error>(unexpect, Task_error::failed); },
+      [] { return expected<int, Task_error>(3); });
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(*r, 3);
+}
+
+TEST(when_any, all_fail) {
+  work_stealing_pool pool(2);
+  auto r = when_any(
+      pool,
+      [] { return expected<void, Task_error>(unexpect, Task_error::other); },
+      [] { return expected<void, Task_error>(unexpect, Task_error::failed); });
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), Task_error::other);
+}
+
+// NOLINTEND(*-avoid-magic-numbers)